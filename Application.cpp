@@ -1,419 +1,718 @@
-///////////////////////////////////////////////////////////////////////////
-//
-// Main class for HCI2 assignments
-// Authors:
-//		Milan Gruner (2017)
-//		Alec Schneider (2017)
-//		Raoul Baron (2017)
-//		Stefan Neubert (2015)
-//		Stephan Richter (2011)
-//		Patrick Loehne (2012)
-//
-///////////////////////////////////////////////////////////////////////////
-
-#include "Application.h"
-
-#include <iostream>
-
-#include <opencv2/imgproc/imgproc.hpp>
-#include <opencv2/highgui/highgui.hpp>
-
-#include "framework/DepthCamera.h"
-#include "framework/KinectMotor.h"
-#include "framework/SkeletonTracker.h"
-
-#include "Calibration.h"
-
-#define BOOST_SIGNALS_NO_DEPRECATION_WARNING
-#include <boost/thread.hpp>
-#define _USE_MATH_DEFINES
-#include <math.h>
-#include "uist-game/GameServer.h"
-#include "uist-game/GameClient.h"
-#include "uist-game/Game.h"
-#include "uist-game/GameUnit.h"
-
-const int Application::uist_level = 1;
-const char* Application::uist_server = "127.0.0.1";
-
-// constants
-const int IMAGE_AMPLIFICATION = 10; // multiplied into the depth texture
-const int IMAGE_HEIGHT = 480;
-const int IMAGE_WIDTH = 640;
-const int CROSSHAIR_SIZE = 50;
-const int MIN_CONTOUR_POINTS = 10;
-const int OVER_SIX_THOUSAND = 6001; //MIN_ELLIPSE_SIZE
-const int MIN_CONTOUR_SIZE = 100;
-const int MAX_CONTOUR_SIZE = 200;
-const double LEG_THRESHOLD = 35; // TODO figure out automatically
-
-void Application::warpImage()
-{
-	///////////////////////////////////////////////////////////////////////////
-	//
-	// To do:
-	//
-	// In this method, you have to warp the image in order to project it on
-	// the floor so that it appears undistorted
-	//
-	// * m_outputImage: The image you have to distort in a way that it appears
-	//                  undistorted on the floor
-	// * m_calibration: The calibration class giving you access to the matrices
-	//                  you have computed
-	//
-	///////////////////////////////////////////////////////////////////////////
-	warpPerspective(m_gameImage, m_outputImage, m_calibration->physicalToProjector(), m_outputImage.size(), cv::INTER_LINEAR);
-}
-
-void Application::processFrame()
-{
-	///////////////////////////////////////////////////////////////////////////
-	//
-	// To do:
-	//
-	// This method will be called every frame of the camera. Insert code here in
-	// order to recognize touch and select the according game units.
-	// These images will help you doing so:
-	//
-	// * m_bgrImage: The image of the Kinect's color camera
-	// * m_depthImage: The image of the Kinects's depth sensor
-	// * m_gameImage: The undistorted image in which the UIST game is rendered.
-	// * m_outputImage: The final image distorted in a way that it appears
-	//                  undistorted on the floor.
-	//
-	///////////////////////////////////////////////////////////////////////////
-
-	flipHorizontally();
-	warpImage();
-	std::vector<cv::Point2f> touchVector, transformedTouchVector;
-	touchVector.push_back(detectTouch());
-	cv::perspectiveTransform(touchVector, transformedTouchVector,
-		m_calibration->cameraToPhysical());
-	cv::Point2f touch = transformedTouchVector[0];
-
-	// draw circle at touch position
-	cv::circle(m_outputImage, touch, 10, cv::Scalar(0, 255, 255), 3);
-
-	int minDistanceIndex = -1;
-	float minDistance = 0;
-	for (int i = 0; i < 5; i++) {
-		auto unit = m_gameClient->game()->unitByIndex(i);
-		float currentDistance = sqrt(pow((touch.x-unit->x()), 2) + pow((touch.y-unit->y()), 2));
-		if (minDistanceIndex == -1 || minDistance > currentDistance) {
-			minDistance = currentDistance;
-			minDistanceIndex = i;
-		}
-		m_gameClient->game()->highlightUnit(i, false);
-	}
-	auto unit = m_gameClient->game()->unitByIndex(minDistanceIndex);
-	m_gameClient->game()->moveUnit(minDistanceIndex, (float)atan2((unit->y() - touch.y), (unit->x() - touch.x)), 0.1f);
-	m_gameClient->game()->highlightUnit(minDistanceIndex, true);
-}
-
-cv::Point2f Application::detectTouch() {
-	if(!m_isTouchCalibrated)
-		calibrateTouch();
-
-	cv::Mat withoutGround, thresholdedDepth, src, diff;
-	double maxValue = 255;
-
-	// Amplify and convert image from 16bit to 8bit
-	m_depthImage *= IMAGE_AMPLIFICATION;
-	m_depthImage.convertTo(src, CV_8UC1, 1.0/256.0, 0);
-
-	// removes calibration image from depth image
-	// so only parts that moved since then are still visible
-	cv::absdiff(src, m_calibrationImage, diff);
-
-	// blur to remove artifacts
-	cv::medianBlur(diff, diff, 25);
-
-	// amplify to generate a higher contrast image
-	diff *= 10;
-
-	// thresholding pass (remove leg etc.)
-	cv::threshold(diff, withoutGround, LEG_THRESHOLD, maxValue, cv::THRESH_TOZERO_INV);
-	cv::threshold(withoutGround, thresholdedDepth, 20, maxValue, cv::THRESH_TOZERO);
-
-	//cv::imshow("tresholding result", withoutGround);
-
-	// find outlines
-	std::vector<std::vector<cv::Point>> contours;
-	std::vector<cv::Vec4i> hierarchy;
-	cv::findContours(thresholdedDepth, contours, hierarchy, CV_RETR_TREE,
-		CV_CHAIN_APPROX_SIMPLE, cv::Point(0, 0));
-
-	// add real color image to output
-	// m_outputImage = m_bgrImage; //thresholdedDepth
-
-	// fit ellipses & determine center points
-	std::vector<cv::RotatedRect> minEllipses(contours.size());
-	std::vector<cv::Point2f> centerPoints(contours.size());
-	cv::RotatedRect currentEllipse;
-	cv::Point2f currentCenter;
-	float currentSize;
-	cv::Scalar drawColor;
-
-	// is there any foot found in this frame?
-	bool anyEllipseValid = false;
-	double maxEllipseSize = 0.0;
-	cv::Point2f maxEllipseCenter(-1.0, -1.0);
-
-	for(auto i = 0u; i < contours.size(); i++) {
-		// don't use too small shapes (point count)
-		if(contours[i].size() < MIN_CONTOUR_POINTS)
-			continue;
-
-		currentEllipse = cv::fitEllipse(cv::Mat(contours[i]));
-		currentCenter = currentEllipse.center;
-		currentSize = currentEllipse.size.width * currentEllipse.size.height;
-
-		// filter out too small ellipses
-		// find ellipse with the maximum size
-		anyEllipseValid = true;
-
-		// sample every N frames
-		if(currentSize > maxEllipseSize) {
-			maxEllipseCenter = currentCenter;
-			maxEllipseSize = currentSize;
-			drawColor = cv::Scalar(0, 255, 255);
-		}
-
-		minEllipses[i] = currentEllipse;
-
-		centerPoints.push_back(currentCenter);
-
-		// TODO remove debug output
-		//std::cout << "Center: " << currentCenter.x << "," << currentCenter.y << std::endl;
-
-		drawColor = cv::Scalar(255, 255, 255);
-
-		cv::ellipse(thresholdedDepth, currentEllipse, drawColor, 2, 8);
-
-		// draw contours and ellipses
-		//cv::drawContours(m_outputImage, contours, i, drawColor, 1, 8, std::vector<cv::Vec4i>(), 0, cv::Point());
-		//cv::ellipse(m_outputImage, minEllipses[i], drawColor, 2, 8);
-	}
-
-	// only write to path log if valid center point was found (not -1 in coords)
-	m_isTouching = maxEllipseCenter.x >= 0.0 && maxEllipseCenter.y >= 0.0;
-
-	return maxEllipseCenter;
-}
-
-void Application::calibrateTouch() {
-	m_depthCamera->getFrame(m_bgrImage, m_depthImage);
-	flipHorizontally();
-	m_depthImage *= IMAGE_AMPLIFICATION;
-	m_depthImage.convertTo(m_calibrationImage, CV_8UC1, 1.0/256.0, 0);
-
-	m_isTouchCalibrated = true;
-
-	double min, max;
-	cv::minMaxLoc(m_calibrationImage, &min, &max);
-	m_groundValue = max;
-}
-
-void Application::flipHorizontally() {
-	cv::flip(m_bgrImage, m_bgrFlipImage, 1);
-	m_bgrImage = m_bgrFlipImage;
-	cv::flip(m_depthImage, m_depthFlipImage, 1);
-	m_depthImage = m_depthFlipImage;
-}
-
-void Application::processSkeleton(XnUserID userId)
-{
-	///////////////////////////////////////////////////////////////////////////
-	//
-	// To do:
-	//
-	// This method will be called every frame of the camera for each tracked user.
-	// Insert code here in order to fulfill the assignment.
-	//
-	// Below is an example how to retrieve a skeleton joint position and
-	// (if needed) how to convert its position into image space.
-	//
-	///////////////////////////////////////////////////////////////////////////
-
-	m_skeletonTracker->drawSkeleton(m_bgrImage, userId);
-
-	xn::SkeletonCapability skeletonCap = m_skeletonTracker->getSkeletonCapability();
-
-	XnSkeletonJointPosition leftHand;
-	skeletonCap.GetSkeletonJointPosition(userId, XN_SKEL_LEFT_HAND, leftHand);
-	cv::Point2f imagePosition = m_skeletonTracker->getProjectedPosition(leftHand);
-}
-
-void Application::loop()
-{
-	int key = cv::waitKey(20);
-
-	// If projector and camera aren't calibrated, do this and nothing else
-	if (!m_calibration->hasTerminated())
-	{
-		if (key == 'q')
-			m_isFinished = true;
-
-		if(m_depthCamera)
-		{
-			m_depthCamera->getFrame(m_bgrImage, m_depthImage);
-		}
-		m_calibration->loop(m_bgrImage, m_depthImage);
-
-		return;
-	}
-
-	switch (key)
-	{
-	case 'q': // quit
-		m_isFinished = true;
-		break;
-	case 'p': // screenshot
-		makeScreenshots();
-		break;
-	// run the loaded level
-	case 'r':
-		if(m_gameServer)
-			m_gameServer->startGame();
-		break;
-	// Move fist (0) game unit with wasd
-	case 'w': // north
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->moveUnit(0, (float)M_PI_2, 1.f);
-		break;
-	case 'a': // west
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->moveUnit(0, (float)M_PI, 1.f);
-		break;
-	case 's': // south
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->moveUnit(0, 3 * (float)M_PI_2, 1.f);
-		break;
-	case 'd': // east
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->moveUnit(0, 0.f, 1.f);
-		break;
-	// stop the first (0) game unit
-	case ' ':
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->moveUnit(0, 0.f, 0.f);
-		break;
-	// highlight the first (0) game unit
-	case 'h':
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->highlightUnit(0, true);
-		break;
-	case 'u':
-		if(m_gameClient && m_gameClient->game())
-			m_gameClient->game()->highlightUnit(0, false);
-		break;
-	case 'c':
-		std::cout << "Calibrating touch recognition..." << std::endl;
-		calibrateTouch();
-		std::cout << "Found ground value: " << m_groundValue << std::endl;
-	}
-
-	if(m_isFinished) return;
-
-	if(m_gameClient && m_gameClient->game())
-		m_gameClient->game()->render(m_gameImage);
-
-	if(m_depthCamera)
-	{
-		m_depthCamera->getFrame(m_bgrImage, m_depthImage);
-		processFrame();
-	}
-
-	if(m_skeletonTracker)
-	{
-		std::set<XnUserID>& users = m_skeletonTracker->getTrackedUsers();
-		for (std::set<XnUserID>::iterator i = users.begin(); i != users.end(); ++i)
-			processSkeleton(*i);
-	}
-
-	//cv::imshow("bgr", m_bgrImage);
-	//cv::imshow("depth", m_depthImage);
-	cv::imshow("output", m_outputImage);
-	cv::imshow("calibration", m_calibrationImage);
-	//cv::imshow("UIST game", m_gameImage);
-}
-
-void Application::makeScreenshots()
-{
-	cv::imwrite("color.png", m_bgrImage);
-	cv::imwrite("depth.png", m_depthImage);
-	cv::imwrite("output.png", m_outputImage);
-}
-
-Application::Application()
-	: m_isFinished(false)
-	, m_isTouching(false)
-	, m_depthCamera(nullptr)
-	, m_kinectMotor(nullptr)
-	, m_skeletonTracker(nullptr)
-	, m_gameClient(nullptr)
-	, m_gameServer(nullptr)
-	, m_calibration(nullptr)
-{
-	// If you want to control the motor / LED
-	// m_kinectMotor = new KinectMotor;
-
-	// Not used for UIST game demo, uncomment for skeleton assignment
-	m_depthCamera = new DepthCamera;
-	// m_skeletonTracker = new SkeletonTracker(m_depthCamera);
-
-	// open windows
-	cv::namedWindow("output", CV_WINDOW_NORMAL);
-	cv::namedWindow("depth", CV_WINDOW_AUTOSIZE);
-	cv::namedWindow("bgr", CV_WINDOW_AUTOSIZE);
-	cv::namedWindow("UIST game", CV_WINDOW_AUTOSIZE);
-
-	// create work buffers
-	m_bgrImage = cv::Mat(480, 640, CV_8UC3);
-	m_depthImage = cv::Mat(480, 640, CV_16UC1);
-	m_outputImage = cv::Mat(480, 640, CV_8UC1);
-	m_gameImage = cv::Mat(480, 480, CV_8UC3);
-	m_bgrFlipImage = cv::Mat(480, 640, CV_8UC3);
-	m_depthFlipImage = cv::Mat(480, 640, CV_16UC1);
-	m_gameFlipImage = cv::Mat(480, 640, CV_8UC3);
-	m_calibrationImage = cv::Mat(480, 640, CV_8UC1);
-
-	if(uist_server == "127.0.0.1") {
-		m_gameServer = new GameServer;
-		m_gameClient = new GameClient;
-		m_gameServer->run();
-		m_gameServer->loadGame(uist_level);
-		boost::this_thread::sleep(boost::posix_time::milliseconds(100));
-	}
-	m_gameClient->run();
-	m_gameClient->connectToServer(uist_server);
-	std::cout << "[Info] Connected to " << uist_server << std::endl;
-
-	m_calibration = new Calibration();
-}
-
-Application::~Application()
-{
-	// Fails due to race conditions in UIST game
-	/*
-	if (m_gameClient)
-	{
-		m_gameClient->stop();
-		delete m_gameClient;
-	}
-	if (m_gameServer)
-	{
-		m_gameServer->stop();
-		delete m_gameServer;
-	}*/
-
-	if (m_skeletonTracker) delete m_skeletonTracker;
-	if (m_depthCamera) delete m_depthCamera;
-	if (m_kinectMotor) delete m_kinectMotor;
-	if (m_calibration) delete m_calibration;
-}
-
-bool Application::isFinished()
-{
-	return m_isFinished;
-}
+///////////////////////////////////////////////////////////////////////////
+//
+// Main class for HCI2 assignments
+// Authors:
+//		Milan Gruner (2017)
+//		Alec Schneider (2017)
+//		Raoul Baron (2017)
+//		Stefan Neubert (2015)
+//		Stephan Richter (2011)
+//		Patrick Loehne (2012)
+//
+///////////////////////////////////////////////////////////////////////////
+
+#include "Application.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "framework/DepthCamera.h"
+#include "framework/KinectMotor.h"
+#include "framework/SkeletonTracker.h"
+#include "framework/RecordedFrameSource.h"
+#include "framework/SyntheticFrameSource.h"
+#include "framework/RawFileSink.h"
+
+#include "Calibration.h"
+#include "PerformanceOverlay.h"
+#include "Presenter.h"
+#include "ProjectorWarp.h"
+#include "uist-game/SpatialGrid.h"
+
+#define BOOST_SIGNALS_NO_DEPRECATION_WARNING
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "uist-game/GameServer.h"
+#include "uist-game/GameClient.h"
+#include "uist-game/Game.h"
+#include "uist-game/UnitStates.h"
+#include "uist-game/Profiling.h"
+
+const int Application::uist_level = 1;
+const char* Application::uist_server = "127.0.0.1";
+
+// constants
+const int IMAGE_AMPLIFICATION = 10; // multiplied into the depth texture
+const int IMAGE_HEIGHT = 480;
+const int IMAGE_WIDTH = 640;
+const int CROSSHAIR_SIZE = 50;
+const int MIN_CONTOUR_POINTS = 10;
+const int OVER_SIX_THOUSAND = 6001; //MIN_ELLIPSE_SIZE
+const int MIN_CONTOUR_SIZE = 100;
+const int MAX_CONTOUR_SIZE = 200;
+const double LEG_THRESHOLD = 35; // TODO figure out automatically
+const double MIN_TOUCH_SIZE_RATIO = 0.25; // of the biggest foot in the frame
+const float UNIT_GRID_CELL_SIZE = 40.f; // game coordinates
+
+// called by the presenter thread, which only exists with GTK (see Application)
+static void showOutputImage(const cv::Mat &image)
+{
+	cv::imshow("output", image);
+}
+
+void Application::warpImage()
+{
+	PROFILE_SCOPE("warpImage");
+
+	///////////////////////////////////////////////////////////////////////////
+	//
+	// To do:
+	//
+	// In this method, you have to warp the image in order to project it on
+	// the floor so that it appears undistorted
+	//
+	// * m_outputImage: The image you have to distort in a way that it appears
+	//                  undistorted on the floor
+	// * m_calibration: The calibration class giving you access to the matrices
+	//                  you have computed
+	//
+	///////////////////////////////////////////////////////////////////////////
+	m_projectorWarp->warp(m_gameImage, m_calibration->physicalToProjector(), m_outputImage);
+}
+
+void Application::processFrame()
+{
+	///////////////////////////////////////////////////////////////////////////
+	//
+	// To do:
+	//
+	// This method will be called every frame of the camera. Insert code here in
+	// order to recognize touch and select the according game units.
+	// These images will help you doing so:
+	//
+	// * m_bgrImage: The image of the Kinect's color camera
+	// * m_depthImage: The image of the Kinects's depth sensor
+	// * m_gameImage: The undistorted image in which the UIST game is rendered.
+	// * m_outputImage: The final image distorted in a way that it appears
+	//                  undistorted on the floor.
+	//
+	///////////////////////////////////////////////////////////////////////////
+
+	PROFILE_SCOPE("processFrame");
+
+	flipHorizontally();
+	warpImage();
+	std::vector<cv::Point2f> cameraTouches = detectTouches(), touches, projectorTouches;
+	if(!cameraTouches.empty())
+	{
+		cv::perspectiveTransform(cameraTouches, touches,
+			m_calibration->cameraToPhysical());
+
+		// the markers are drawn into the output image, which has the
+		// projector's resolution
+		cv::perspectiveTransform(touches, projectorTouches,
+			m_calibration->physicalToProjector());
+	}
+
+	if(!m_gameClient || !m_gameClient->game())
+		return;
+
+	// index the own units of the latest game state, as far as they can be
+	// addressed by the input commands
+	const UnitStates &units = m_gameClient->game()->ownUnitStates();
+	auto numberOfUnits = std::min<size_t>(units.size(), Game::MAXIMAL_UNIT_INDEX + 1);
+	m_unitGrid->clear();
+	for (auto i = 0u; i < numberOfUnits; i++) {
+		if (units.flags[i] & UnitStates::UNIT_LIVING)
+			m_unitGrid->insert(i, units.x[i], units.y[i]);
+	}
+
+	// each touch takes the nearest unit no other touch has taken yet
+	std::vector<bool> &isAssigned = m_isUnitAssigned;
+	isAssigned.assign(numberOfUnits, false);
+	for (auto i = 0u; i < touches.size(); i++) {
+		const cv::Point2f &touch = touches[i];
+		const cv::Point2f &projectorTouch = projectorTouches[i];
+
+		// draw circle at touch position
+		cv::circle(m_outputImage, projectorTouch, 10, cv::Scalar(0, 255, 255), 3);
+		m_projectorWarp->addOutputRect(cv::Rect((int)projectorTouch.x - 13, (int)projectorTouch.y - 13, 27, 27));
+
+		int unitIndex = m_unitGrid->nearest(touch.x, touch.y, FLT_MAX, &isAssigned);
+		// more feet than units left, the marker is still shown
+		if (unitIndex < 0)
+			continue;
+
+		isAssigned[unitIndex] = true;
+		m_gameClient->game()->moveUnit(unitIndex, (float)atan2((units.y[unitIndex] - touch.y), (units.x[unitIndex] - touch.x)), 0.1f);
+	}
+
+	// only changed highlights are actually sent
+	for (auto i = 0u; i < numberOfUnits; i++)
+		m_gameClient->game()->highlightUnit(i, isAssigned[i]);
+}
+
+std::vector<cv::Point2f> Application::detectTouches() {
+	PROFILE_SCOPE("detectTouches");
+
+	if(!m_isTouchCalibrated)
+		calibrateTouch();
+
+	cv::Mat withoutGround, thresholdedDepth, src, diff;
+	double maxValue = 255;
+
+	{
+		PROFILE_SCOPE("detectTouches: convert");
+
+		// Amplify and convert image from 16bit to 8bit
+		m_depthImage *= IMAGE_AMPLIFICATION;
+		m_depthImage.convertTo(src, CV_8UC1, 1.0/256.0, 0);
+
+		// removes calibration image from depth image
+		// so only parts that moved since then are still visible
+		cv::absdiff(src, m_calibrationImage, diff);
+	}
+
+	{
+		PROFILE_SCOPE("detectTouches: medianBlur");
+
+		// blur to remove artifacts
+		cv::medianBlur(diff, diff, 25);
+	}
+
+	{
+		PROFILE_SCOPE("detectTouches: threshold");
+
+		// amplify to generate a higher contrast image
+		diff *= 10;
+
+		// thresholding pass (remove leg etc.)
+		cv::threshold(diff, withoutGround, LEG_THRESHOLD, maxValue, cv::THRESH_TOZERO_INV);
+		cv::threshold(withoutGround, thresholdedDepth, 20, maxValue, cv::THRESH_TOZERO);
+	}
+
+	//cv::imshow("tresholding result", withoutGround);
+
+	// find outlines
+	std::vector<std::vector<cv::Point>> contours;
+	std::vector<cv::Vec4i> hierarchy;
+	{
+		PROFILE_SCOPE("detectTouches: findContours");
+
+		cv::findContours(thresholdedDepth, contours, hierarchy, CV_RETR_TREE,
+			CV_CHAIN_APPROX_SIMPLE, cv::Point(0, 0));
+	}
+
+	// add real color image to output
+	// m_outputImage = m_bgrImage; //thresholdedDepth
+
+	// fit ellipses & determine center points
+	std::vector<cv::RotatedRect> minEllipses(contours.size());
+	std::vector<cv::Point2f> centerPoints;
+	std::vector<float> ellipseSizes;
+	cv::RotatedRect currentEllipse;
+	cv::Point2f currentCenter;
+	float currentSize;
+	cv::Scalar drawColor;
+
+	double maxEllipseSize = 0.0;
+
+	PROFILE_SCOPE("detectTouches: fitEllipse");
+
+	for(auto i = 0u; i < contours.size(); i++) {
+		// don't use too small shapes (point count)
+		if(contours[i].size() < MIN_CONTOUR_POINTS)
+			continue;
+
+		currentEllipse = cv::fitEllipse(cv::Mat(contours[i]));
+		currentCenter = currentEllipse.center;
+		currentSize = currentEllipse.size.width * currentEllipse.size.height;
+
+		// find ellipse with the maximum size
+		if(currentSize > maxEllipseSize)
+			maxEllipseSize = currentSize;
+
+		minEllipses[i] = currentEllipse;
+
+		centerPoints.push_back(currentCenter);
+		ellipseSizes.push_back(currentSize);
+
+		// TODO remove debug output
+		//std::cout << "Center: " << currentCenter.x << "," << currentCenter.y << std::endl;
+
+		drawColor = cv::Scalar(255, 255, 255);
+
+		cv::ellipse(thresholdedDepth, currentEllipse, drawColor, 2, 8);
+
+		// draw contours and ellipses
+		//cv::drawContours(m_outputImage, contours, i, drawColor, 1, 8, std::vector<cv::Vec4i>(), 0, cv::Point());
+		//cv::ellipse(m_outputImage, minEllipses[i], drawColor, 2, 8);
+	}
+
+	// filter out ellipses much smaller than the biggest one (noise, not feet)
+	std::vector<cv::Point2f> touches;
+	for(auto i = 0u; i < centerPoints.size(); i++) {
+		if(ellipseSizes[i] >= MIN_TOUCH_SIZE_RATIO * maxEllipseSize)
+			touches.push_back(centerPoints[i]);
+	}
+
+	m_isTouching = !touches.empty();
+
+	return touches;
+}
+
+void Application::calibrateTouch() {
+	m_frameSource->getFrame(m_bgrImage, m_depthImage);
+	flipHorizontally();
+	m_depthImage *= IMAGE_AMPLIFICATION;
+	m_depthImage.convertTo(m_calibrationImage, CV_8UC1, 1.0/256.0, 0);
+
+	m_isTouchCalibrated = true;
+
+	double min, max;
+	cv::minMaxLoc(m_calibrationImage, &min, &max);
+	m_groundValue = max;
+}
+
+void Application::flipHorizontally() {
+	cv::flip(m_bgrImage, m_bgrFlipImage, 1);
+	m_bgrImage = m_bgrFlipImage;
+	cv::flip(m_depthImage, m_depthFlipImage, 1);
+	m_depthImage = m_depthFlipImage;
+}
+
+void Application::processSkeleton(XnUserID userId)
+{
+	///////////////////////////////////////////////////////////////////////////
+	//
+	// To do:
+	//
+	// This method will be called every frame of the camera for each tracked user.
+	// Insert code here in order to fulfill the assignment.
+	//
+	// Below is an example how to retrieve a skeleton joint position and
+	// (if needed) how to convert its position into image space.
+	//
+	///////////////////////////////////////////////////////////////////////////
+
+	m_skeletonTracker->drawSkeleton(m_bgrImage, userId);
+
+	xn::SkeletonCapability skeletonCap = m_skeletonTracker->getSkeletonCapability();
+
+	XnSkeletonJointPosition leftHand;
+	skeletonCap.GetSkeletonJointPosition(userId, XN_SKEL_LEFT_HAND, leftHand);
+	cv::Point2f imagePosition = m_skeletonTracker->getProjectedPosition(leftHand);
+}
+
+void Application::loop()
+{
+	int key;
+	{
+		PROFILE_SCOPE("waitKey");
+		key = m_options.isHeadless ? -1 : cv::waitKey(20);
+	}
+
+	// If projector and camera aren't calibrated, do this and nothing else
+	if (!m_calibration->hasTerminated())
+	{
+		if (key == 'q')
+			m_isFinished = true;
+
+		if(m_frameSource)
+		{
+			m_frameSource->getFrame(m_bgrImage, m_depthImage);
+		}
+		m_calibration->loop(m_bgrImage, m_depthImage, m_options.calibrationFile);
+
+		return;
+	}
+
+	switch (key)
+	{
+	case 'q': // quit
+		m_isFinished = true;
+		break;
+	case 'p': // screenshot
+		makeScreenshots();
+		break;
+	case 't': // write the profiling trace (if compiled with UIST_PROFILING)
+		if(Profiling::exportChromeTrace("trace.json"))
+			std::cout << "Wrote trace.json" << std::endl;
+		break;
+	case 'i': // show / hide the performance overlay
+		m_performanceOverlay->toggle();
+		break;
+	case 'v': // start / stop recording frames for RecordedFrameSource
+		m_isRecording = !m_isRecording;
+		std::cout << (m_isRecording ? "Recording" : "Stopped recording")
+			<< " frames." << std::endl;
+		break;
+	// run the loaded level
+	case 'r':
+		if(m_gameServer)
+			m_gameServer->startGame();
+		break;
+	// Move fist (0) game unit with wasd
+	case 'w': // north
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->moveUnit(0, (float)M_PI_2, 1.f);
+		break;
+	case 'a': // west
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->moveUnit(0, (float)M_PI, 1.f);
+		break;
+	case 's': // south
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->moveUnit(0, 3 * (float)M_PI_2, 1.f);
+		break;
+	case 'd': // east
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->moveUnit(0, 0.f, 1.f);
+		break;
+	// stop the first (0) game unit
+	case ' ':
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->moveUnit(0, 0.f, 0.f);
+		break;
+	// highlight the first (0) game unit
+	case 'h':
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->highlightUnit(0, true);
+		break;
+	case 'u':
+		if(m_gameClient && m_gameClient->game())
+			m_gameClient->game()->highlightUnit(0, false);
+		break;
+	case 'c':
+		std::cout << "Calibrating touch recognition..." << std::endl;
+		calibrateTouch();
+		std::cout << "Found ground value: " << m_groundValue << std::endl;
+	}
+
+	if(m_isFinished) return;
+
+	m_performanceOverlay->countFrame();
+
+	if(m_gameClient)
+		m_gameClient->sendRequests();
+
+	if(m_gameClient && m_gameClient->game())
+	{
+		PROFILE_SCOPE("Game::render");
+		m_gameClient->game()->render(m_gameImage);
+
+		m_projectorWarp->addGameRects(m_gameClient->game()->dirtyRects());
+	}
+
+	if(m_frameSource)
+	{
+		{
+			PROFILE_SCOPE("capture");
+			m_frameSource->getFrame(m_bgrImage, m_depthImage);
+		}
+
+		// record before processing, which flips and amplifies the images
+		if(m_isRecording)
+			recordFrame();
+
+		processFrame();
+	}
+
+	if(m_skeletonTracker)
+	{
+		std::set<XnUserID>& users = m_skeletonTracker->getTrackedUsers();
+		for (std::set<XnUserID>::iterator i = users.begin(); i != users.end(); ++i)
+			processSkeleton(*i);
+	}
+
+	if(m_performanceOverlay->isVisible())
+	{
+		if(m_performanceOverlay->isOutdated())
+			updatePerformanceOverlay();
+		m_performanceOverlay->render(m_outputImage);
+		m_projectorWarp->addOutputRect(m_performanceOverlay->bounds());
+	}
+
+	// warped and drawn in color, converted to the output format at the end
+	cv::Mat outputFrame = m_outputImage;
+	if(m_options.outputType != m_outputImage.type())
+	{
+		PROFILE_SCOPE("convertOutput");
+		cv::cvtColor(m_outputImage, m_convertedOutputImage,
+			m_options.outputType == CV_8UC1 ? cv::COLOR_BGR2GRAY : cv::COLOR_BGR2BGRA);
+		outputFrame = m_convertedOutputImage;
+	}
+
+	if(m_options.isHeadless)
+	{
+		PROFILE_SCOPE("FrameSink::write");
+		if(m_frameSink)
+			m_frameSink->write(outputFrame);
+	}
+	else
+	{
+		PROFILE_SCOPE("imshow");
+		//cv::imshow("bgr", m_bgrImage);
+		//cv::imshow("depth", m_depthImage);
+		if(m_presenter)
+			m_presenter->submit(outputFrame);
+		else
+			cv::imshow("output", outputFrame);
+		cv::imshow("calibration", m_calibrationImage);
+		//cv::imshow("UIST game", m_gameImage);
+	}
+
+	m_frameNumber++;
+	if(m_options.maxFrames > 0 && m_frameNumber >= m_options.maxFrames)
+		m_isFinished = true;
+}
+
+void Application::makeScreenshots()
+{
+	cv::imwrite("color.png", m_bgrImage);
+	cv::imwrite("depth.png", m_depthImage);
+	cv::imwrite("output.png", m_outputImage);
+}
+
+void Application::recordFrame()
+{
+	cv::imwrite(RecordedFrameSource::colorFileName(".", m_recordedFrames), m_bgrImage);
+	cv::imwrite(RecordedFrameSource::depthFileName(".", m_recordedFrames), m_depthImage);
+	m_recordedFrames++;
+}
+
+void Application::updatePerformanceOverlay()
+{
+	// stages measured on this thread by PROFILE_SCOPE
+	static const char *stages[] = {
+		"capture", "detectTouches", "Game::render", "warpImage",
+		"convertOutput", "imshow", "FrameSink::write"
+	};
+
+	std::vector<std::string> lines;
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(1);
+
+	line << "fps " << m_performanceOverlay->fps();
+	lines.push_back(line.str());
+
+	bool isProfiling = false;
+	for (size_t i = 0; i < sizeof(stages) / sizeof(stages[0]); i++)
+	{
+		double duration = Profiling::averageDuration(stages[i]);
+		if (duration < 0)
+			continue;
+
+		line.str("");
+		line << stages[i] << " " << duration << " ms";
+		lines.push_back(line.str());
+		isProfiling = true;
+	}
+
+	if (!isProfiling)
+		lines.push_back("stages: n/a (make profile)");
+
+	line.str("");
+	double roundTripTime = m_gameClient ? m_gameClient->roundTripTime() : -1.0;
+	if (roundTripTime < 0)
+		line << "rtt n/a";
+	else
+		line << "rtt " << roundTripTime << " ms";
+	lines.push_back(line.str());
+
+	line.str("");
+	if (m_gameServer)
+		line << "tick jitter " << m_gameServer->tickJitter() << " ms";
+	else
+		line << "tick jitter n/a";
+	lines.push_back(line.str());
+
+	if (m_gameServer)
+	{
+		line.str("");
+		line << std::setprecision(3)
+			<< "sim step " << m_gameServer->simulationCost() << " ms";
+		lines.push_back(line.str());
+	}
+
+	if (m_presenter)
+	{
+		line.str("");
+		line << "present " << m_presenter->latency() << " ms, "
+			<< m_presenter->droppedFrames() << " dropped";
+		lines.push_back(line.str());
+	}
+
+	GamePtr game = m_gameClient ? m_gameClient->game() : GamePtr();
+	if (game)
+	{
+		line.str("");
+		line << "score " << game->score() << " (" << game->arrivedUnits()
+			<< " arrived, " << game->survivingUnits() << " surviving)";
+		lines.push_back(line.str());
+	}
+
+	m_performanceOverlay->setLines(lines);
+}
+
+ApplicationOptions::ApplicationOptions()
+	: isHeadless(false)
+	, frameSource("kinect")
+	, calibrationFile("calibration.yml")
+	, maxFrames(0)
+	, numberOfRooms(1)
+	, numberOfWorkers(0)
+	, refreshRate(60.0)
+	, outputSize(640, 480)
+	, outputType(CV_8UC3)
+{
+}
+
+Application::Application(const ApplicationOptions &options)
+	: m_gameClient(nullptr)
+	, m_gameServer(nullptr)
+	, m_options(options)
+	, m_depthCamera(nullptr)
+	, m_frameSource(nullptr)
+	, m_frameSink(nullptr)
+	, m_kinectMotor(nullptr)
+	, m_skeletonTracker(nullptr)
+	, m_calibration(nullptr)
+	, m_performanceOverlay(nullptr)
+	, m_presenter(nullptr)
+	, m_projectorWarp(nullptr)
+	, m_unitGrid(nullptr)
+	, m_isFinished(false)
+	, m_isTouching(false)
+	, m_isRecording(false)
+	, m_frameNumber(0)
+	, m_recordedFrames(0)
+{
+	PROFILE_THREAD("application");
+
+	// If you want to control the motor / LED
+	// m_kinectMotor = new KinectMotor;
+
+	if(m_options.frameSource == "synthetic")
+		m_frameSource = new SyntheticFrameSource;
+	else if(m_options.frameSource != "kinect")
+		m_frameSource = new RecordedFrameSource(m_options.frameSource);
+	else
+	{
+		m_depthCamera = new DepthCamera;
+		m_frameSource = m_depthCamera;
+	}
+
+	// Not used for UIST game demo, uncomment for skeleton assignment
+	// m_skeletonTracker = new SkeletonTracker(m_depthCamera);
+
+	if(m_options.isHeadless)
+	{
+		if(!m_options.frameSink.empty())
+			m_frameSink = new RawFileSink(m_options.frameSink);
+	}
+	else
+	{
+		// open windows
+		cv::namedWindow("output", CV_WINDOW_NORMAL);
+		cv::namedWindow("depth", CV_WINDOW_AUTOSIZE);
+		cv::namedWindow("bgr", CV_WINDOW_AUTOSIZE);
+		cv::namedWindow("UIST game", CV_WINDOW_AUTOSIZE);
+
+		// HighGUI may only be called from two threads if its backend runs the
+		// event loop on a thread of its own, which only GTK does (and then
+		// returns nonzero). Other backends, e. g. Win32, pump the messages of a
+		// window on the thread that created it, so all windows stay on this
+		// thread there and the output is shown without a presenter.
+		if(cv::startWindowThread())
+		{
+			m_presenter = new Presenter(&showOutputImage, m_options.refreshRate);
+			m_presenter->start();
+		}
+	}
+
+	// create work buffers
+	m_bgrImage = cv::Mat(480, 640, CV_8UC3);
+	m_depthImage = cv::Mat(480, 640, CV_16UC1);
+	m_outputImage = cv::Mat(m_options.outputSize, CV_8UC3);
+	m_gameImage = cv::Mat(480, 480, CV_8UC3);
+	m_bgrFlipImage = cv::Mat(480, 640, CV_8UC3);
+	m_depthFlipImage = cv::Mat(480, 640, CV_16UC1);
+	m_gameFlipImage = cv::Mat(480, 640, CV_8UC3);
+	m_calibrationImage = cv::Mat(480, 640, CV_8UC1);
+
+	if(uist_server == "127.0.0.1") {
+		m_gameServer = new GameServer(std::max(1, m_options.numberOfRooms),
+			std::max(0, m_options.numberOfWorkers));
+		m_gameClient = new GameClient;
+		m_gameServer->run();
+		if(!m_options.journalDirectory.empty())
+			m_gameServer->recordMatches(m_options.journalDirectory);
+		m_gameServer->loadGame(uist_level);
+		boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+	}
+	m_gameClient->run();
+	m_gameClient->connectToServer(uist_server);
+	std::cout << "[Info] Connected to " << uist_server << std::endl;
+
+	m_calibration = new Calibration(m_options.isHeadless);
+	m_calibration->setProjectorSize(m_options.outputSize);
+	m_projectorWarp = new ProjectorWarp;
+	m_performanceOverlay = new PerformanceOverlay;
+	m_unitGrid = new SpatialGrid((float)m_gameImage.cols, (float)m_gameImage.rows,
+		UNIT_GRID_CELL_SIZE);
+
+	if(m_options.isHeadless)
+	{
+		if(!m_calibration->load(m_options.calibrationFile))
+			m_calibration->loadDefault();
+
+		// nobody can press 'r' without a window
+		if(m_gameServer)
+			m_gameServer->startGame();
+	}
+}
+
+Application::~Application()
+{
+	// Fails due to race conditions in UIST game
+	/*
+	if (m_gameClient)
+	{
+		m_gameClient->stop();
+		delete m_gameClient;
+	}
+	if (m_gameServer)
+	{
+		m_gameServer->stop();
+		delete m_gameServer;
+	}*/
+
+	// before the trace, which then includes the presenter's last frames
+	if (m_presenter) delete m_presenter;
+
+	if (!m_options.traceFile.empty())
+		Profiling::exportChromeTrace(m_options.traceFile);
+
+	if (m_skeletonTracker) delete m_skeletonTracker;
+	if (m_frameSource && m_frameSource != m_depthCamera) delete m_frameSource;
+	if (m_depthCamera) delete m_depthCamera;
+	if (m_frameSink) delete m_frameSink;
+	if (m_kinectMotor) delete m_kinectMotor;
+	if (m_calibration) delete m_calibration;
+	if (m_performanceOverlay) delete m_performanceOverlay;
+	if (m_projectorWarp) delete m_projectorWarp;
+	if (m_unitGrid) delete m_unitGrid;
+}
+
+bool Application::isFinished()
+{
+	return m_isFinished;
+}
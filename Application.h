@@ -1,63 +1,142 @@
-#pragma once
-
-#include <opencv2/core/core.hpp>
-#include <boost/tokenizer.hpp>
-#include <XnTypes.h>
-
-class GameClient;
-class GameServer;
-
-class DepthCamera;
-class KinectMotor;
-class SkeletonTracker;
-
-class Calibration;
-
-class Application
-{
-public:
-	Application();
-	virtual ~Application();
-
-	void loop();
-
-	void warpImage();
-	void processFrame();
-	void processSkeleton(XnUserID userId);
-
-	void makeScreenshots();
-	void clearOutputImage();
-	void flipHorizontally();
-	void calibrateTouch();
-	cv::Point2f detectTouch();
-
-	bool isFinished();
-
-protected:
-	GameClient *m_gameClient;
-	GameServer *m_gameServer;
-
-	DepthCamera *m_depthCamera;
-	KinectMotor *m_kinectMotor;
-	SkeletonTracker *m_skeletonTracker;
-
-	Calibration *m_calibration;
-
-	cv::Mat m_bgrImage;
-	cv::Mat m_depthImage;
-	cv::Mat m_outputImage;
-	cv::Mat m_gameImage;
-	cv::Mat m_bgrFlipImage;
-	cv::Mat m_depthFlipImage;
-	cv::Mat m_gameFlipImage;
-	cv::Mat m_calibrationImage;
-
-	bool m_isFinished;
-	bool m_isTouchCalibrated;
-	bool m_isTouching;
-
-	double m_groundValue;
-
-	static const int uist_level;
-	static const char *uist_server;
-};
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <boost/tokenizer.hpp>
+#include <XnTypes.h>
+
+class GameClient;
+class GameServer;
+
+class DepthCamera;
+class FrameSource;
+class FrameSink;
+class KinectMotor;
+class SkeletonTracker;
+
+class Calibration;
+class SpatialGrid;
+class PerformanceOverlay;
+class Presenter;
+class ProjectorWarp;
+
+struct ApplicationOptions
+{
+	ApplicationOptions();
+
+	// Run without any HighGUI window (no calibration wizard, no key input)
+	bool isHeadless;
+
+	// "kinect", "synthetic" or a directory with recorded frames
+	std::string frameSource;
+
+	// File receiving the output frames in headless mode ("-" for stdout)
+	std::string frameSink;
+
+	// Calibration to load in headless mode (identity if missing)
+	std::string calibrationFile;
+
+	// Stop after this many frames (0 for no limit)
+	int maxFrames;
+
+	// Chrome trace written on exit (needs UIST_PROFILING, see "make profile")
+	std::string traceFile;
+
+	// Games the local game server hosts at the same time
+	int numberOfRooms;
+
+	// Threads running the server's game rooms (0 for one per core)
+	int numberOfWorkers;
+
+	// Directory the server records the matches to (empty for none)
+	std::string journalDirectory;
+
+	// Frames per second the output window is shown at, the projector's
+	// refresh rate
+	double refreshRate;
+
+	// Resolution of the output frames, the projector's native mode, so the
+	// operating system doesn't scale them again
+	cv::Size outputSize;
+
+	// Format of the output frames: CV_8UC3 (BGR), CV_8UC1 (gray) or CV_8UC4
+	// (BGRA)
+	int outputType;
+};
+
+class Application
+{
+public:
+	Application(const ApplicationOptions &options = ApplicationOptions());
+	virtual ~Application();
+
+	void loop();
+
+	void warpImage();
+	void processFrame();
+	void processSkeleton(XnUserID userId);
+
+	void makeScreenshots();
+	void recordFrame();
+	void updatePerformanceOverlay();
+	void clearOutputImage();
+	void flipHorizontally();
+	void calibrateTouch();
+	std::vector<cv::Point2f> detectTouches();
+
+	bool isFinished();
+
+protected:
+	GameClient *m_gameClient;
+	GameServer *m_gameServer;
+
+	ApplicationOptions m_options;
+
+	DepthCamera *m_depthCamera;
+	FrameSource *m_frameSource;
+	FrameSink *m_frameSink;
+	KinectMotor *m_kinectMotor;
+	SkeletonTracker *m_skeletonTracker;
+
+	Calibration *m_calibration;
+	PerformanceOverlay *m_performanceOverlay;
+
+	// shows m_outputImage on its own thread (not in headless mode)
+	Presenter *m_presenter;
+
+	// warps the changed regions of m_gameImage into m_outputImage
+	ProjectorWarp *m_projectorWarp;
+
+	// own units of the latest game state, for assigning touches
+	SpatialGrid *m_unitGrid;
+
+	// own units already taken by a touch in the current frame
+	std::vector<bool> m_isUnitAssigned;
+
+	cv::Mat m_bgrImage;
+	cv::Mat m_depthImage;
+	cv::Mat m_outputImage;
+	cv::Mat m_gameImage;
+	cv::Mat m_bgrFlipImage;
+	cv::Mat m_depthFlipImage;
+	cv::Mat m_gameFlipImage;
+	cv::Mat m_calibrationImage;
+
+	// m_outputImage in the output format, if that isn't BGR
+	cv::Mat m_convertedOutputImage;
+
+	bool m_isFinished;
+	bool m_isTouchCalibrated;
+	bool m_isTouching;
+	bool m_isRecording;
+
+	int m_frameNumber;
+	int m_recordedFrames;
+
+	double m_groundValue;
+
+	static const int uist_level;
+	static const char *uist_server;
+};
@@ -1,64 +1,81 @@
-#pragma once
-
-#include <opencv2/core/core.hpp>
-
-#include <vector>
-#include <string>
-
-class Calibration
-{
-public:
-	Calibration();
-	~Calibration();
-
-	void restart();
-	bool hasTerminated() const;
-
-	void loop(const cv::Mat &bgrImage, const cv::Mat &depthImage);
-
-	void handleMouseClick(int x, int y, int flags);
-
-	const cv::Mat &physicalToProjector() const;
-	const cv::Mat &projectorToPhysical() const;
-
-	const cv::Mat &physicalToCamera() const;
-	const cv::Mat &cameraToPhysical() const;
-
-protected:
-	void calibrate(const cv::Mat &bgrImage);
-	void calibrateProjector();
-	void calibrateCamera(const cv::Mat &bgrImage);
-
-	void computeHomography();
-
-	// own (team Y3t1z)
-	void logMatrices();
-	std::vector<cv::Point2f> makeRect(cv::Point2f topLeft, cv::Point2f bottomRight);
-
-	bool m_hasTerminated;
-
-	cv::Mat m_calibrationImage;
-	cv::Mat bgrFlipImage;
-
-	std::vector<std::string> m_circleNames;
-
-	bool m_isProjectorCalibrated;
-	int m_numberOfProjectorCoordinates;
-
-	// The 4 points for calibrating the projector
-	std::vector<cv::Point2f> m_projectorCoordinates;
-
-	bool m_isCameraCalibrated;
-	int m_numberOfCameraCoordinates;
-
-	// The 4 points for calibrating the camera
-	std::vector<cv::Point2f> m_cameraCoordinates;
-
-	// matrices to convert between physical and projector space
-	cv::Mat m_physicalToProjector;
-	cv::Mat m_projectorToPhysical;
-
-	// matrices to convert between physical and camera space
-	cv::Mat m_physicalToCamera;
-	cv::Mat m_cameraToPhysical;
-};
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+#include <string>
+
+class Calibration
+{
+public:
+	Calibration(bool isHeadless = false);
+	~Calibration();
+
+	void restart();
+	bool hasTerminated() const;
+
+	// store / restore the clicked points, e. g. for running headless
+	bool save(const std::string &fileName) const;
+	bool load(const std::string &fileName);
+	void loadDefault();
+
+	// runs the wizard; the finished calibration is saved to fileName
+	void loop(const cv::Mat &bgrImage, const cv::Mat &depthImage,
+		const std::string &fileName);
+
+	// resolution of the output image; the projector points are clicked in
+	// the wizard's 640x480 image and scaled to it
+	void setProjectorSize(cv::Size projectorSize);
+
+	void handleMouseClick(int x, int y, int flags);
+
+	const cv::Mat &physicalToProjector() const;
+	const cv::Mat &projectorToPhysical() const;
+
+	const cv::Mat &physicalToCamera() const;
+	const cv::Mat &cameraToPhysical() const;
+
+protected:
+	void calibrate(const cv::Mat &bgrImage, const std::string &fileName);
+	void calibrateProjector();
+	void calibrateCamera(const cv::Mat &bgrImage);
+
+	void computeHomography();
+
+	// own (team Y3t1z)
+	void logMatrices();
+	std::vector<cv::Point2f> makeRect(cv::Point2f topLeft, cv::Point2f bottomRight);
+
+	bool m_hasTerminated;
+	bool m_isHeadless;
+
+	// set by loadDefault, whose projector points are output pixels
+	bool m_isDefault;
+
+	cv::Mat m_calibrationImage;
+	cv::Mat bgrFlipImage;
+
+	std::vector<std::string> m_circleNames;
+
+	bool m_isProjectorCalibrated;
+	int m_numberOfProjectorCoordinates;
+
+	// The 4 points for calibrating the projector
+	std::vector<cv::Point2f> m_projectorCoordinates;
+
+	bool m_isCameraCalibrated;
+	int m_numberOfCameraCoordinates;
+
+	// The 4 points for calibrating the camera
+	std::vector<cv::Point2f> m_cameraCoordinates;
+
+	cv::Size m_projectorSize;
+
+	// matrices to convert between physical and projector space
+	cv::Mat m_physicalToProjector;
+	cv::Mat m_projectorToPhysical;
+
+	// matrices to convert between physical and camera space
+	cv::Mat m_physicalToCamera;
+	cv::Mat m_cameraToPhysical;
+};
@@ -0,0 +1,144 @@
+#include "PerformanceOverlay.h"
+
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "uist-game/Clock.h"
+
+const int OVERLAY_FONT = cv::FONT_HERSHEY_PLAIN;
+const double OVERLAY_FONT_SCALE = 1.0;
+const int OVERLAY_MARGIN = 4;
+const uint64_t OVERLAY_UPDATE_INTERVAL = 250000; // microseconds
+const uint64_t FPS_INTERVAL = 1000000; // microseconds
+
+PerformanceOverlay::PerformanceOverlay()
+	: m_isVisible(false)
+	, m_lastUpdateTime(0)
+	, m_lastFpsTime(Clock::microseconds())
+	, m_framesSinceFps(0)
+	, m_fps(0.0)
+{
+	createAtlas();
+}
+
+void PerformanceOverlay::createAtlas()
+{
+	int baseline = 0;
+	m_glyphSize = cv::Size(0, 0);
+
+	for (char c = s_firstCharacter; c <= s_lastCharacter; c++)
+	{
+		cv::Size size = cv::getTextSize(std::string(1, c), OVERLAY_FONT,
+			OVERLAY_FONT_SCALE, 1, &baseline);
+		m_glyphSize.width = std::max(m_glyphSize.width, size.width);
+		m_glyphSize.height = std::max(m_glyphSize.height, size.height + baseline);
+	}
+
+	// one pixel spacing between glyphs and lines
+	m_glyphSize.width += 1;
+	m_glyphSize.height += 2;
+
+	int numberOfGlyphs = s_lastCharacter - s_firstCharacter + 1;
+	m_atlas = cv::Mat::zeros(m_glyphSize.height, m_glyphSize.width * numberOfGlyphs, CV_8UC1);
+
+	for (char c = s_firstCharacter; c <= s_lastCharacter; c++)
+	{
+		int x = (c - s_firstCharacter) * m_glyphSize.width;
+		cv::putText(m_atlas, std::string(1, c),
+			cv::Point(x, m_glyphSize.height - baseline - 1),
+			OVERLAY_FONT, OVERLAY_FONT_SCALE, cv::Scalar(255));
+	}
+}
+
+void PerformanceOverlay::toggle()
+{
+	m_isVisible = !m_isVisible;
+
+	// show up-to-date values right away
+	m_lastUpdateTime = 0;
+}
+
+bool PerformanceOverlay::isVisible() const
+{
+	return m_isVisible;
+}
+
+void PerformanceOverlay::countFrame()
+{
+	m_framesSinceFps++;
+
+	uint64_t now = Clock::microseconds();
+	if (now - m_lastFpsTime >= FPS_INTERVAL)
+	{
+		m_fps = m_framesSinceFps * 1000000.0 / (now - m_lastFpsTime);
+		m_framesSinceFps = 0;
+		m_lastFpsTime = now;
+	}
+}
+
+double PerformanceOverlay::fps() const
+{
+	return m_fps;
+}
+
+bool PerformanceOverlay::isOutdated() const
+{
+	return Clock::microseconds() - m_lastUpdateTime >= OVERLAY_UPDATE_INTERVAL;
+}
+
+void PerformanceOverlay::setLines(const std::vector<std::string> &lines)
+{
+	m_lastUpdateTime = Clock::microseconds();
+
+	size_t maxLength = 0;
+	for (size_t i = 0; i < lines.size(); i++)
+		maxLength = std::max(maxLength, lines[i].size());
+
+	m_textMask = cv::Mat::zeros(
+		(int)lines.size() * m_glyphSize.height + 2 * OVERLAY_MARGIN,
+		(int)maxLength * m_glyphSize.width + 2 * OVERLAY_MARGIN, CV_8UC1);
+
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		for (size_t j = 0; j < lines[i].size(); j++)
+		{
+			char c = lines[i][j];
+			if (c < s_firstCharacter || c > s_lastCharacter)
+				c = '?';
+
+			cv::Rect glyph((c - s_firstCharacter) * m_glyphSize.width, 0,
+				m_glyphSize.width, m_glyphSize.height);
+			cv::Mat target = m_textMask(cv::Rect(
+				OVERLAY_MARGIN + (int)j * m_glyphSize.width,
+				OVERLAY_MARGIN + (int)i * m_glyphSize.height,
+				m_glyphSize.width, m_glyphSize.height));
+
+			m_atlas(glyph).copyTo(target);
+		}
+	}
+}
+
+void PerformanceOverlay::render(cv::Mat &image) const
+{
+	if (!m_isVisible || m_textMask.empty())
+		return;
+
+	int width = std::min(m_textMask.cols, image.cols);
+	int height = std::min(m_textMask.rows, image.rows);
+	if (width <= 0 || height <= 0)
+		return;
+
+	// black background for contrast on the floor, white text on top
+	cv::Mat region = image(cv::Rect(0, 0, width, height));
+	region.setTo(cv::Scalar::all(0));
+	region.setTo(cv::Scalar::all(255), m_textMask(cv::Rect(0, 0, width, height)));
+}
+
+cv::Rect PerformanceOverlay::bounds() const
+{
+	if (!m_isVisible || m_textMask.empty())
+		return cv::Rect();
+
+	return cv::Rect(0, 0, m_textMask.cols, m_textMask.rows);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+
+// Small text block in the top left corner of the output image (fps, stage
+// timings, network). All glyphs are rasterized once into an atlas, the text
+// block is only recomposed when the text changes, so drawing it each frame is
+// just two masked fills of a small region.
+class PerformanceOverlay
+{
+public:
+	PerformanceOverlay();
+
+	void toggle();
+	bool isVisible() const;
+
+	// call once per frame, measures the frame rate
+	void countFrame();
+	double fps() const;
+
+	// whether the text should be refreshed (a few times per second)
+	bool isOutdated() const;
+	void setLines(const std::vector<std::string> &lines);
+
+	void render(cv::Mat &image) const;
+
+	// region render draws over, empty if it draws nothing
+	cv::Rect bounds() const;
+
+protected:
+	void createAtlas();
+
+	static const char s_firstCharacter = ' ';
+	static const char s_lastCharacter = '~';
+
+	bool m_isVisible;
+
+	// all printable ASCII characters side by side, CV_8UC1
+	cv::Mat m_atlas;
+	cv::Size m_glyphSize;
+
+	// composed text block used as mask, CV_8UC1
+	cv::Mat m_textMask;
+
+	uint64_t m_lastUpdateTime;
+	uint64_t m_lastFpsTime;
+	int m_framesSinceFps;
+	double m_fps;
+};
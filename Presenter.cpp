@@ -0,0 +1,144 @@
+#include "Presenter.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "uist-game/Clock.h"
+#include "uist-game/Profiling.h"
+
+// weight of the latest frame in the smoothed latency
+const double LATENCY_SMOOTHING = 0.1;
+
+Presenter::Presenter(const PresentFunction &present, double refreshRate)
+	: m_present(present)
+	, m_refreshInterval((uint64_t)(1000000.0 / std::max(1.0, refreshRate)))
+	, m_isRunning(false)
+	, m_submitTime(0)
+	, m_hasFrame(false)
+	, m_latency(0.0)
+	, m_presentedFrames(0)
+	, m_droppedFrames(0)
+{
+}
+
+Presenter::~Presenter()
+{
+	stop();
+}
+
+void Presenter::start()
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	if (m_isRunning)
+		return;
+
+	m_isRunning = true;
+	m_thread = boost::thread(boost::bind(&Presenter::run, this));
+}
+
+void Presenter::stop()
+{
+	{
+		boost::lock_guard<boost::mutex> lock(m_mutex);
+		m_isRunning = false;
+	}
+
+	m_condition.notify_all();
+
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void Presenter::submit(const cv::Mat &image)
+{
+	{
+		boost::lock_guard<boost::mutex> lock(m_mutex);
+
+		if (m_hasFrame)
+			m_droppedFrames++;
+
+		// reuses the buffer's memory, the caller keeps its image
+		image.copyTo(m_backBuffer);
+		m_submitTime = Clock::microseconds();
+		m_hasFrame = true;
+	}
+
+	m_condition.notify_one();
+}
+
+double Presenter::latency() const
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	return m_latency;
+}
+
+unsigned int Presenter::presentedFrames() const
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	return m_presentedFrames;
+}
+
+unsigned int Presenter::droppedFrames() const
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	return m_droppedFrames;
+}
+
+void Presenter::run()
+{
+	PROFILE_THREAD("presenter");
+
+	uint64_t nextRefreshTime = Clock::microseconds();
+
+	boost::unique_lock<boost::mutex> lock(m_mutex);
+
+	while (true)
+	{
+		while (m_isRunning && !m_hasFrame)
+			m_condition.wait(lock);
+
+		if (!m_isRunning)
+			break;
+
+		// wait for the refresh; a newer frame submitted meanwhile is shown
+		// instead of this one
+		uint64_t now = Clock::microseconds();
+		if (now < nextRefreshTime)
+		{
+			lock.unlock();
+			boost::this_thread::sleep(boost::posix_time::microseconds(
+				(boost::int64_t)(nextRefreshTime - now)));
+			lock.lock();
+
+			if (!m_isRunning)
+				break;
+		}
+
+		cv::swap(m_frontBuffer, m_backBuffer);
+		uint64_t submitTime = m_submitTime;
+		m_hasFrame = false;
+
+		lock.unlock();
+
+		{
+			PROFILE_SCOPE("present");
+			m_present(m_frontBuffer);
+		}
+
+		uint64_t presentTime = Clock::microseconds();
+
+		// a late frame restarts the refresh schedule instead of bursting
+		nextRefreshTime = std::max(nextRefreshTime + m_refreshInterval,
+			presentTime);
+
+		lock.lock();
+
+		double latency = (presentTime - submitTime) / 1000.0;
+		m_latency = m_presentedFrames ? m_latency + LATENCY_SMOOTHING * (latency - m_latency)
+			: latency;
+		m_presentedFrames++;
+	}
+}
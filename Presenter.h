@@ -0,0 +1,57 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+// Shows the finished output frames on its own thread, so that a slow window
+// system call does not delay the next capture. Frames are copied into a back
+// buffer, which the thread swaps with its front buffer at most once per
+// refresh of the projector. A frame that is not presented before the next one
+// arrives is dropped instead of queued, so the picture never lags behind.
+class Presenter
+{
+public:
+	typedef boost::function<void (const cv::Mat &image)> PresentFunction;
+
+	// present is called on the presenter thread for each shown frame
+	Presenter(const PresentFunction &present, double refreshRate);
+	virtual ~Presenter();
+
+	void start();
+	void stop();
+
+	// copies a finished frame, which replaces one still waiting
+	void submit(const cv::Mat &image);
+
+	// milliseconds from submit until the frame was shown, smoothed
+	double latency() const;
+	unsigned int presentedFrames() const;
+	unsigned int droppedFrames() const;
+
+protected:
+	void run();
+
+	PresentFunction m_present;
+	uint64_t m_refreshInterval; // microseconds
+
+	boost::thread m_thread;
+	mutable boost::mutex m_mutex;
+	boost::condition_variable m_condition;
+	bool m_isRunning;
+
+	// written by submit, guarded by m_mutex
+	cv::Mat m_backBuffer;
+	uint64_t m_submitTime;
+	bool m_hasFrame;
+
+	// only touched by the presenter thread
+	cv::Mat m_frontBuffer;
+
+	double m_latency;
+	unsigned int m_presentedFrames;
+	unsigned int m_droppedFrames;
+};
@@ -0,0 +1,90 @@
+#include "ProjectorWarp.h"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+// more changed regions between two warps are warped as a whole, e. g. when
+// rendering without camera frames, which would collect them forever
+const size_t MAX_GAME_RECTS = 64;
+
+ProjectorWarp::ProjectorWarp()
+	: m_isOutdated(true)
+	, m_outputData(nullptr)
+{
+}
+
+void ProjectorWarp::addGameRects(const std::vector<cv::Rect> &rects)
+{
+	if (m_isOutdated)
+		return;
+
+	m_gameRects.insert(m_gameRects.end(), rects.begin(), rects.end());
+
+	if (m_gameRects.size() > MAX_GAME_RECTS)
+		invalidate();
+}
+
+void ProjectorWarp::addOutputRect(const cv::Rect &rect)
+{
+	if (!m_isOutdated && rect.area() > 0)
+		m_outputRects.push_back(rect);
+}
+
+void ProjectorWarp::invalidate()
+{
+	m_isOutdated = true;
+	m_gameRects.clear();
+	m_outputRects.clear();
+}
+
+void ProjectorWarp::warp(const cv::Mat &gameImage, const cv::Mat &homography, cv::Mat &outputImage)
+{
+	cv::Mat homography64;
+	homography.convertTo(homography64, CV_64F);
+
+	if (m_isOutdated || outputImage.data != m_outputData
+		|| outputImage.type() != gameImage.type()
+		|| cv::norm(homography64, m_homography, cv::NORM_INF) > 0)
+	{
+		cv::warpPerspective(gameImage, outputImage, homography64, outputImage.size(), cv::INTER_LINEAR);
+		m_homography = homography64;
+		m_outputData = outputImage.data;
+		m_gameRects.clear();
+		m_outputRects.clear();
+		m_isOutdated = false;
+		return;
+	}
+
+	// only the projector-space bounding boxes of the changed regions
+	std::vector<cv::Rect> outputRects;
+	outputRects.swap(m_outputRects);
+
+	for (size_t i = 0; i < m_gameRects.size(); i++)
+	{
+		// one pixel more on each side, which linear interpolation reads
+		const cv::Rect &rect = m_gameRects[i];
+		std::vector<cv::Point2f> corners(4), projectedCorners;
+		corners[0] = cv::Point2f(rect.x - 1.f, rect.y - 1.f);
+		corners[1] = cv::Point2f(rect.x + rect.width + 1.f, rect.y - 1.f);
+		corners[2] = cv::Point2f(rect.x - 1.f, rect.y + rect.height + 1.f);
+		corners[3] = cv::Point2f(rect.x + rect.width + 1.f, rect.y + rect.height + 1.f);
+		cv::perspectiveTransform(corners, projectedCorners, homography64);
+
+		cv::Rect outputRect = cv::boundingRect(projectedCorners);
+		outputRects.push_back(cv::Rect(outputRect.x - 1, outputRect.y - 1,
+			outputRect.width + 2, outputRect.height + 2));
+	}
+	m_gameRects.clear();
+
+	cv::Rect outputBounds(0, 0, outputImage.cols, outputImage.rows);
+	for (size_t i = 0; i < outputRects.size(); i++)
+	{
+		cv::Rect rect = outputRects[i] & outputBounds;
+		if (rect.area() == 0)
+			continue;
+
+		// the same homography, shifted to the region's top left corner
+		cv::Mat shift = (cv::Mat_<double>(3, 3) << 1, 0, -rect.x, 0, 1, -rect.y, 0, 0, 1);
+		cv::Mat region = outputImage(rect);
+		cv::warpPerspective(gameImage, region, shift * homography64, rect.size(), cv::INTER_LINEAR);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+// Warps the game image into the output image for the projector. Only the
+// projector-space bounding boxes of the regions changed since the last warp
+// are warped again (see Game::dirtyRects), plus the regions drawn over the
+// output afterwards. A new homography or output image warps everything.
+class ProjectorWarp
+{
+public:
+	ProjectorWarp();
+
+	// regions of the game image rendered since the last warp
+	void addGameRects(const std::vector<cv::Rect> &rects);
+
+	// region of the output image drawn over after the last warp (touches,
+	// performance overlay), warped again to erase it
+	void addOutputRect(const cv::Rect &rect);
+
+	// warps everything in the next call
+	void invalidate();
+
+	void warp(const cv::Mat &gameImage, const cv::Mat &homography, cv::Mat &outputImage);
+
+protected:
+	std::vector<cv::Rect> m_gameRects;
+	std::vector<cv::Rect> m_outputRects;
+	bool m_isOutdated;
+
+	// homography of the last warp, as CV_64F
+	cv::Mat m_homography;
+	const unsigned char *m_outputData;
+};
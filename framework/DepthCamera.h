@@ -1,32 +1,34 @@
-#pragma once
-
-#include <string>
-
-#include <opencv2/core/core.hpp>
-#include <opencv2/highgui/highgui.hpp>
-
-#include <XnCppWrapper.h>
-
-class DepthCamera
-{
-public:
-	DepthCamera();
-	virtual ~DepthCamera();
-
-	static const XnMapOutputMode DepthCamera::OUTPUT_MODE;
-
-	void getFrame(cv::Mat &bgrImage, cv::Mat &depthImage);
-	
-friend class SkeletonTracker;
-protected:
-	xn::Context m_context;
-	xn::ScriptNode m_scriptNode;
-
-	xn::DepthGenerator m_depthGenerator;
-	xn::ImageGenerator m_imageGenerator;
-	xn::DepthMetaData m_depthMetaData;
-	xn::ImageMetaData m_imageMetaData;
-
-	cv::VideoCapture m_bgrReader;
-	cv::VideoCapture m_depthReader;
+#pragma once
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include <XnCppWrapper.h>
+
+#include "FrameSource.h"
+
+class DepthCamera : public FrameSource
+{
+public:
+	DepthCamera();
+	virtual ~DepthCamera();
+
+	static const XnMapOutputMode DepthCamera::OUTPUT_MODE;
+
+	void getFrame(cv::Mat &bgrImage, cv::Mat &depthImage);
+	
+friend class SkeletonTracker;
+protected:
+	xn::Context m_context;
+	xn::ScriptNode m_scriptNode;
+
+	xn::DepthGenerator m_depthGenerator;
+	xn::ImageGenerator m_imageGenerator;
+	xn::DepthMetaData m_depthMetaData;
+	xn::ImageMetaData m_imageMetaData;
+
+	cv::VideoCapture m_bgrReader;
+	cv::VideoCapture m_depthReader;
 };
\ No newline at end of file
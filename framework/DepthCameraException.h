@@ -1,17 +1,17 @@
-#include <string>
-#include <exception>
-
-#include <XnStatus.h>
-
-class DepthCameraException : public std::exception
-{
-public:
-	DepthCameraException(std::string message);
-	DepthCameraException(std::string description, XnStatus status);
-	virtual ~DepthCameraException();
-
-	virtual const char* what() const;
-
-protected:
-	std::string m_message;
+#include <string>
+#include <exception>
+
+#include <XnStatus.h>
+
+class DepthCameraException : public std::exception
+{
+public:
+	DepthCameraException(std::string message);
+	DepthCameraException(std::string description, XnStatus status);
+	virtual ~DepthCameraException();
+
+	virtual const char* what() const;
+
+protected:
+	std::string m_message;
 };
\ No newline at end of file
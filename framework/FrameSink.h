@@ -0,0 +1,12 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+// Receives the finished output frames when no window is shown.
+class FrameSink
+{
+public:
+	virtual ~FrameSink() {}
+
+	virtual void write(const cv::Mat &image) = 0;
+};
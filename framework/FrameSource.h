@@ -0,0 +1,14 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+// Anything delivering pairs of color and depth frames to the application,
+// e. g. the Kinect or a recording for running without the camera attached.
+class FrameSource
+{
+public:
+	virtual ~FrameSource() {}
+
+	// bgrImage: CV_8UC3, depthImage: CV_16UC1, both 640x480
+	virtual void getFrame(cv::Mat &bgrImage, cv::Mat &depthImage) = 0;
+};
@@ -0,0 +1,45 @@
+#include "RawFileSink.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+RawFileSink::RawFileSink(const std::string &fileName)
+{
+	if (fileName == "-")
+	{
+		m_file = stdout;
+#ifdef _WIN32
+		// Text mode would turn every 0x0A byte into 0x0D 0x0A
+		_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	}
+	else
+		m_file = fopen(fileName.c_str(), "wb");
+
+	if (!m_file)
+		throw std::runtime_error("Could not open output file " + fileName);
+}
+
+RawFileSink::~RawFileSink()
+{
+	if (m_file && m_file != stdout)
+		fclose(m_file);
+}
+
+void RawFileSink::write(const cv::Mat &image)
+{
+	int header[3] = { image.rows, image.cols, image.type() };
+	bool isWritten = fwrite(header, sizeof(header), 1, m_file) == 1;
+
+	size_t rowLength = image.cols * image.elemSize();
+	for (int y = 0; y < image.rows && isWritten; y++)
+		isWritten = fwrite(image.ptr(y), rowLength, 1, m_file) == 1;
+
+	// E. g. the disk is full or the reading end of the pipe was closed
+	if (!isWritten || fflush(m_file) != 0)
+		throw std::runtime_error("Could not write output frame");
+}
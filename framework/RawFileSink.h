@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "FrameSink.h"
+
+// Appends every frame to a file (or to stdout if the name is "-") as a small
+// header (rows, cols, OpenCV type as int32) followed by the raw pixel rows, so
+// the output can be piped into a socket or a video encoder. With stdout, all
+// other console output has to go to stderr (see main). Throws a
+// std::runtime_error if a frame cannot be written.
+class RawFileSink : public FrameSink
+{
+public:
+	RawFileSink(const std::string &fileName);
+	virtual ~RawFileSink();
+
+	void write(const cv::Mat &image);
+
+protected:
+	FILE *m_file;
+};
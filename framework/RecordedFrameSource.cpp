@@ -0,0 +1,55 @@
+#include "RecordedFrameSource.h"
+
+#include <cstdio>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include "DepthCameraException.h"
+
+RecordedFrameSource::RecordedFrameSource(const std::string &directory)
+	: m_directory(directory)
+	, m_nextFrame(0)
+{
+	if (cv::imread(colorFileName(m_directory, 0)).empty())
+		throw DepthCameraException("No recorded frames found in " + m_directory);
+}
+
+RecordedFrameSource::~RecordedFrameSource()
+{}
+
+std::string RecordedFrameSource::colorFileName(const std::string &directory, int frame)
+{
+	char name[32];
+	sprintf(name, "/color_%05d.png", frame);
+	return directory + name;
+}
+
+std::string RecordedFrameSource::depthFileName(const std::string &directory, int frame)
+{
+	char name[32];
+	sprintf(name, "/depth_%05d.png", frame);
+	return directory + name;
+}
+
+void RecordedFrameSource::getFrame(cv::Mat &bgrImage, cv::Mat &depthImage)
+{
+	cv::Mat bgr = cv::imread(colorFileName(m_directory, m_nextFrame), CV_LOAD_IMAGE_COLOR);
+
+	// Start over at the end of the recording
+	if (bgr.empty() && m_nextFrame > 0)
+	{
+		m_nextFrame = 0;
+		bgr = cv::imread(colorFileName(m_directory, m_nextFrame), CV_LOAD_IMAGE_COLOR);
+	}
+
+	cv::Mat depth = cv::imread(depthFileName(m_directory, m_nextFrame), CV_LOAD_IMAGE_ANYDEPTH);
+
+	if (bgr.empty() || depth.empty() || depth.type() != CV_16UC1)
+		throw DepthCameraException("Could not read recorded frame from " + m_directory);
+
+	// Copy into the caller's buffers so they keep their memory
+	bgr.copyTo(bgrImage);
+	depth.copyTo(depthImage);
+
+	m_nextFrame++;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#include "FrameSource.h"
+
+// Replays color_#####.png / depth_#####.png pairs (as written by the 'v' key of
+// the application) from a directory and starts over after the last frame.
+class RecordedFrameSource : public FrameSource
+{
+public:
+	RecordedFrameSource(const std::string &directory);
+	virtual ~RecordedFrameSource();
+
+	static std::string colorFileName(const std::string &directory, int frame);
+	static std::string depthFileName(const std::string &directory, int frame);
+
+	void getFrame(cv::Mat &bgrImage, cv::Mat &depthImage);
+
+protected:
+	std::string m_directory;
+	int m_nextFrame;
+};
@@ -0,0 +1,36 @@
+#include "SyntheticFrameSource.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+// raw depth values (millimeters) of the floor and of the foot above it
+const unsigned short FLOOR_DEPTH = 2400;
+const unsigned short FOOT_DEPTH = 2330;
+const int FRAMES_PER_CIRCLE = 300;
+
+SyntheticFrameSource::SyntheticFrameSource()
+	: m_frame(0)
+{}
+
+SyntheticFrameSource::~SyntheticFrameSource()
+{}
+
+void SyntheticFrameSource::getFrame(cv::Mat &bgrImage, cv::Mat &depthImage)
+{
+	bgrImage.setTo(cv::Scalar(64, 64, 64));
+	depthImage.setTo(cv::Scalar(FLOOR_DEPTH));
+
+	// The first frames show the empty floor for touch calibration
+	if (m_frame++ < 10)
+		return;
+
+	double angle = 2 * M_PI * (m_frame % FRAMES_PER_CIRCLE) / FRAMES_PER_CIRCLE;
+	cv::Point foot(
+		(int)(depthImage.cols / 2 + 120 * cos(angle)),
+		(int)(depthImage.rows / 2 + 120 * sin(angle)));
+
+	cv::circle(depthImage, foot, 30, cv::Scalar(FOOT_DEPTH), CV_FILLED);
+	cv::circle(bgrImage, foot, 30, cv::Scalar(32, 32, 160), CV_FILLED);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "FrameSource.h"
+
+// Generates a flat floor with a foot moving on a circle in front of it. Needs
+// neither a camera nor recorded data, which makes it suitable for soak tests.
+class SyntheticFrameSource : public FrameSource
+{
+public:
+	SyntheticFrameSource();
+	virtual ~SyntheticFrameSource();
+
+	void getFrame(cv::Mat &bgrImage, cv::Mat &depthImage);
+
+protected:
+	int m_frame;
+};
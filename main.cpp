@@ -1,25 +1,137 @@
-#include "Application.h"
-
-#include <iostream>
-
-#include "framework/DepthCameraException.h"
-
-int main()
-{
-	try
-	{
-		Application application;
-		
-		while (!application.isFinished())
-			application.loop();
-	}
-	catch (DepthCameraException dce)
-	{
-		std::cerr << std::endl << "[DepthCamera Error] " << dce.what() << std::endl;
-		std::cout << std::endl << std::endl << "Press Enter to close the application...";
-		std::cin.ignore();
-		return EXIT_FAILURE;
-	}
-
-	return EXIT_SUCCESS;
+#include "Application.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "framework/DepthCameraException.h"
+
+void printUsage(const char *executable)
+{
+	std::cout << "Usage: " << executable << " [options]" << std::endl
+		<< "  --headless            run without windows" << std::endl
+		<< "  --source <source>     kinect (default), synthetic or a directory" << std::endl
+		<< "                        with recorded frames (see key 'v')" << std::endl
+		<< "  --sink <file>         headless: write output frames to file (- for stdout)" << std::endl
+		<< "  --calibration <file>  calibration the wizard writes, loaded when headless" << std::endl
+		<< "                        (default calibration.yml)" << std::endl
+		<< "  --frames <n>          quit after n frames" << std::endl
+		<< "  --trace <file>        write a Chrome trace on exit (make profile)" << std::endl
+		<< "  --rooms <n>           host n games on the local server (default 1)" << std::endl
+		<< "  --workers <n>         server threads for the rooms (default one per core)" << std::endl
+		<< "  --journal <dir>       record the input of all matches (see match-replay)" << std::endl
+		<< "  --refresh <hz>        refresh rate of the output window (default 60)" << std::endl
+		<< "  --output <w>x<h>      resolution of the output frames (default 640x480)" << std::endl
+		<< "  --format <format>     bgr (default), gray or bgra output frames" << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, ApplicationOptions &options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (!strcmp(argv[i], "--headless"))
+			options.isHeadless = true;
+		else if (!strcmp(argv[i], "--source") && hasValue)
+			options.frameSource = argv[++i];
+		else if (!strcmp(argv[i], "--sink") && hasValue)
+			options.frameSink = argv[++i];
+		else if (!strcmp(argv[i], "--calibration") && hasValue)
+			options.calibrationFile = argv[++i];
+		else if (!strcmp(argv[i], "--frames") && hasValue)
+			options.maxFrames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--trace") && hasValue)
+			options.traceFile = argv[++i];
+		else if (!strcmp(argv[i], "--rooms") && hasValue)
+			options.numberOfRooms = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--workers") && hasValue)
+			options.numberOfWorkers = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--journal") && hasValue)
+			options.journalDirectory = argv[++i];
+		else if (!strcmp(argv[i], "--refresh") && hasValue)
+			options.refreshRate = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--output") && hasValue)
+		{
+			int width = 0, height = 0;
+			if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+				return false;
+			options.outputSize = cv::Size(width, height);
+		}
+		else if (!strcmp(argv[i], "--format") && hasValue)
+		{
+			std::string format = argv[++i];
+			if (format == "bgr")
+				options.outputType = CV_8UC3;
+			else if (format == "gray")
+				options.outputType = CV_8UC1;
+			else if (format == "bgra")
+				options.outputType = CV_8UC4;
+			else
+				return false;
+		}
+		else
+			return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	ApplicationOptions options;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// The raw frames own stdout, so the log messages of all modules, which are
+	// written to std::cout, are redirected to stderr before anything is logged
+	if (options.frameSink == "-")
+		std::cout.rdbuf(std::cerr.rdbuf());
+
+	try
+	{
+		Application application(options);
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+		int frames = 0;
+
+		while (!application.isFinished())
+		{
+			application.loop();
+			frames++;
+		}
+
+		if (options.isHeadless)
+		{
+			double seconds = (boost::posix_time::microsec_clock::universal_time() - start)
+				.total_microseconds() / 1000000.0;
+			std::cerr << "[Info] " << frames << " frames in " << seconds << " s ("
+				<< frames / seconds << " fps)" << std::endl;
+		}
+	}
+	catch (DepthCameraException dce)
+	{
+		std::cerr << std::endl << "[DepthCamera Error] " << dce.what() << std::endl;
+		if (!options.isHeadless)
+		{
+			std::cout << std::endl << std::endl << "Press Enter to close the application...";
+			std::cin.ignore();
+		}
+		return EXIT_FAILURE;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << std::endl << "[Error] " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
 }
\ No newline at end of file
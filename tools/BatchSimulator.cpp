@@ -0,0 +1,318 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Batch simulator
+//
+// Plays many matches of one level between two bots, as fast as possible and
+// without any network, camera or clock, and prints the distribution of the
+// sheep player's score. Useful to balance a level: a level the sheep always
+// win against chasing hunters is too easy. The matches are spread across all
+// cores; each match is seeded with its number, so the results do not depend
+// on the number of threads.
+//
+// Bots: idle (no input), random (random moves) or greedy (sheep run for the
+// goal line, hunters chase the nearest sheep).
+//
+// Usage: batch-simulator <level> [matches] [sheep bot] [hunter bot] [threads]
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include "../uist-game/Game.h"
+#include "../uist-game/GameUnit.h"
+#include "../uist-game/Clock.h"
+#include "../uist-game/LevelFile.h"
+#include "../uist-game/Logging.h"
+#include "../uist-game/TaskScheduler.h"
+
+// Same step length as the game server
+const float STEP_LENGTH = 0.02f;
+
+// Seconds between two decisions of a bot, about as often as a player can
+// redirect a unit with the foot
+const float DECISION_INTERVAL = 0.25f;
+
+const float PI = 3.14159265f;
+
+enum Bot {BOT_IDLE, BOT_RANDOM, BOT_GREEDY};
+
+const PlayerID SHEEP_PLAYER = ID_FIRST_CLIENT;
+const PlayerID HUNTER_PLAYER = ID_FIRST_CLIENT + 1;
+
+typedef boost::random::mt19937 RandomGenerator;
+
+struct MatchResult
+{
+	int arrivedUnits;
+	int survivingUnits;
+	int score;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool parseBot(const std::string &name, Bot &bot)
+{
+	if (name == "idle")
+		bot = BOT_IDLE;
+	else if (name == "random")
+		bot = BOT_RANDOM;
+	else if (name == "greedy")
+		bot = BOT_GREEDY;
+	else
+		return false;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Angle of GameUnit::moveAcceleration pointing from one position to another
+float angleTowards(float fromX, float fromY, float toX, float toY)
+{
+	return atan2(fromY - toY, toX - fromX);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void decide(Game &game, PlayerID playerID, Bot bot,
+	RandomGenerator &randomGenerator)
+{
+	if (bot == BOT_IDLE)
+		return;
+
+	boost::random::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+	// Only up to 256 units per player can be moved, as with real input
+	for (unsigned int i = 0; i < 256; i++)
+	{
+		GameUnitPtr gameUnit = game.unitByIndex(playerID, (uint8_t)i);
+
+		if (!gameUnit)
+			break;
+
+		if (!gameUnit->isLiving() || gameUnit->hasArrived())
+			continue;
+
+		float angle;
+		float strength = 1.0f;
+
+		if (bot == BOT_RANDOM)
+		{
+			angle = 2.0f * PI * uniform(randomGenerator);
+			strength = uniform(randomGenerator);
+		}
+		else if (!gameUnit->isHunting())
+		{
+			// Straight down to the goal line, with some zigzag
+			angle = -0.5f * PI + (uniform(randomGenerator) - 0.5f);
+		}
+		else
+		{
+			GameUnitPtr nearestSheep;
+			float nearestDistance = 0.0f;
+
+			for (unsigned int j = 0; j < 256; j++)
+			{
+				GameUnitPtr sheep = game.unitByIndex(SHEEP_PLAYER, (uint8_t)j);
+
+				if (!sheep)
+					break;
+
+				if (!sheep->isLiving() || sheep->hasArrived())
+					continue;
+
+				float dx = sheep->x() - gameUnit->x();
+				float dy = sheep->y() - gameUnit->y();
+				float distance = dx * dx + dy * dy;
+
+				if (!nearestSheep || distance < nearestDistance)
+				{
+					nearestSheep = sheep;
+					nearestDistance = distance;
+				}
+			}
+
+			if (!nearestSheep)
+				continue;
+
+			angle = angleTowards(gameUnit->x(), gameUnit->y(),
+				nearestSheep->x(), nearestSheep->y());
+		}
+
+		gameUnit->setAcceleration(GameUnit::moveAcceleration(angle,
+			strength));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void simulateMatches(int levelNumber, Bot sheepBot, Bot hunterBot,
+	std::vector<MatchResult> &results, unsigned int begin, unsigned int end)
+{
+	unsigned int stepsPerDecision = (unsigned int)(DECISION_INTERVAL
+		/ STEP_LENGTH + 0.5f);
+
+	for (unsigned int match = begin; match < end; match++)
+	{
+		RandomGenerator randomGenerator(match);
+
+		Game game(NULL);
+		game.load(levelNumber);
+		game.start();
+
+		for (unsigned int step = 0; !game.hasFinished(); step++)
+		{
+			if (step % stepsPerDecision == 0)
+			{
+				decide(game, SHEEP_PLAYER, sheepBot, randomGenerator);
+				decide(game, HUNTER_PLAYER, hunterBot, randomGenerator);
+			}
+
+			game.proceed(STEP_LENGTH);
+		}
+
+		results[match].arrivedUnits = game.arrivedUnits();
+		results[match].survivingUnits = game.survivingUnits();
+		results[match].score = game.score();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int percentile(const std::vector<int> &sortedValues, double fraction)
+{
+	unsigned int index = (unsigned int)(fraction * (sortedValues.size() - 1)
+		+ 0.5);
+
+	return sortedValues[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void printDistribution(const std::string &name, std::vector<int> values)
+{
+	std::sort(values.begin(), values.end());
+
+	double sum = 0.0;
+
+	for (unsigned int i = 0; i < values.size(); i++)
+		sum += values[i];
+
+	std::cout << std::setw(10) << std::left << name << std::right
+		<< std::fixed << std::setprecision(2) << " mean " << std::setw(7)
+		<< sum / values.size()
+		<< "   min " << std::setw(4) << values.front()
+		<< "   p10 " << std::setw(4) << percentile(values, 0.1)
+		<< "   median " << std::setw(4) << percentile(values, 0.5)
+		<< "   p90 " << std::setw(4) << percentile(values, 0.9)
+		<< "   max " << std::setw(4) << values.back() << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void printHistogram(const std::vector<int> &scores)
+{
+	int maximalScore = *std::max_element(scores.begin(), scores.end());
+
+	std::vector<unsigned int> counts(maximalScore + 1, 0);
+
+	for (unsigned int i = 0; i < scores.size(); i++)
+		counts[scores[i]]++;
+
+	unsigned int maximalCount = *std::max_element(counts.begin(),
+		counts.end());
+
+	const unsigned int BAR_LENGTH = 50;
+
+	std::cout << std::endl << "score  matches" << std::endl;
+
+	for (int score = 0; score <= maximalScore; score++)
+	{
+		if (!counts[score])
+			continue;
+
+		std::cout << std::setw(5) << score << "  " << std::setw(7)
+			<< counts[score] << "  "
+			<< std::string((counts[score] * BAR_LENGTH + maximalCount - 1)
+				/ maximalCount, '#') << std::endl;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	Bot sheepBot = BOT_GREEDY;
+	Bot hunterBot = BOT_GREEDY;
+
+	if (argc < 2 || (argc > 3 && !parseBot(argv[3], sheepBot))
+		|| (argc > 4 && !parseBot(argv[4], hunterBot)))
+	{
+		std::cerr << "Usage: " << argv[0] << " <level> [matches]"
+			<< " [sheep bot] [hunter bot] [threads]" << std::endl
+			<< "Bots: idle, random, greedy (default)" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	int levelNumber = atoi(argv[1]);
+	unsigned int numberOfMatches = (argc > 2) ? std::max(1, atoi(argv[2]))
+		: 1000;
+
+	if (LevelFile::fileName(levelNumber).empty())
+	{
+		std::cerr << "There is no level " << levelNumber << " in "
+			<< LevelFile::s_directory << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// As many threads as cores by default
+	TaskScheduler taskScheduler((argc > 5) ? std::max(1, atoi(argv[5])) : 0);
+
+	// Every match would log loading the level and its end
+	Logging::setLevel(Logging::Level::LEVEL_WARNING);
+
+	std::vector<MatchResult> results(numberOfMatches);
+
+	uint64_t start = Clock::microseconds();
+
+	taskScheduler.parallelFor(numberOfMatches, 1,
+		boost::bind(&simulateMatches, levelNumber, sheepBot, hunterBot,
+			boost::ref(results), _1, _2));
+
+	double wallTime = (Clock::microseconds() - start) / 1000000.0;
+
+	std::vector<int> arrivedUnits(numberOfMatches);
+	std::vector<int> survivingUnits(numberOfMatches);
+	std::vector<int> scores(numberOfMatches);
+
+	for (unsigned int i = 0; i < numberOfMatches; i++)
+	{
+		arrivedUnits[i] = results[i].arrivedUnits;
+		survivingUnits[i] = results[i].survivingUnits;
+		scores[i] = results[i].score;
+	}
+
+	std::cout << "level " << levelNumber << ", " << numberOfMatches
+		<< " matches on " << taskScheduler.numberOfThreads()
+		<< " thread(s) in " << std::fixed << std::setprecision(2)
+		<< wallTime << " s (" << std::setprecision(0)
+		<< numberOfMatches * 60.0 / std::max(wallTime, 1e-6)
+		<< "x real time)" << std::endl << std::endl;
+
+	printDistribution("arrived", arrivedUnits);
+	printDistribution("survived", survivingUnits);
+	printDistribution("score", scores);
+	printHistogram(scores);
+
+	return EXIT_SUCCESS;
+}
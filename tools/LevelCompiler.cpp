@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Level compiler
+//
+// Converts a text level (see LevelFile.h) to the binary format, which the game
+// maps into memory instead of parsing it. A compiled levels/levelN.level is
+// preferred over levels/levelN.txt.
+//
+// Usage: level-compiler <input.txt> <output.level>
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <iostream>
+
+#include "../uist-game/LevelFile.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <input.txt> <output.level>"
+			<< std::endl;
+		return EXIT_FAILURE;
+	}
+
+	LevelFile levelFile;
+
+	if (!levelFile.open(argv[1]))
+		return EXIT_FAILURE;
+
+	if (!levelFile.save(argv[2]))
+	{
+		std::cerr << "Could not write " << argv[2] << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << argv[2] << ": " << levelFile.numberOfUnits() << " units, "
+		<< levelFile.numberOfObstacles() << " obstacles" << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Match replay
+//
+// Simulates a match recorded by the game server (--journal) again, as fast as
+// possible and without any network or camera. Prints the cost of the
+// simulation steps and of serializing the unit states for the clients, and a
+// checksum of the final state: replaying the same journal must always give
+// the same checksum, which makes recorded matches usable as bug repros.
+//
+// Usage: match-replay <file.journal> [threads]
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+#include "../uist-game/Game.h"
+#include "../uist-game/GameNetworkInterface.h"
+#include "../uist-game/MatchJournal.h"
+#include "../uist-game/Clock.h"
+#include "../uist-game/TaskScheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Serializes the messages like a server session would, without sending them
+class ReplayNetworkInterface : public GameNetworkInterface
+{
+	public:
+		ReplayNetworkInterface()
+		{
+			numberOfBytes = 0;
+			numberOfMessages = 0;
+		}
+
+		void run()
+		{
+		}
+
+		void stop()
+		{
+		}
+
+		void send(MessageData messageData, PlayerID /* receiverID */)
+		{
+			messageData.copyTo(m_buffer);
+
+			numberOfBytes += messageData.headerLength()
+				+ messageData.contentLength();
+			numberOfMessages++;
+		}
+
+		uint64_t numberOfBytes;
+		uint64_t numberOfMessages;
+
+	protected:
+		char m_buffer[MAX_MESSAGE_LENGTH];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void apply(Game &game, const MatchJournal::Record &record)
+{
+	if (record.type == MatchJournal::RECORD_START)
+	{
+		game.start();
+		return;
+	}
+
+	if (record.type == MatchJournal::RECORD_MOVE)
+		game.applyMove(record.playerID, record.unitIndex, record.angle,
+			record.strength);
+	else if (record.type == MatchJournal::RECORD_HIGHLIGHT)
+		game.applyHighlight(record.playerID, record.unitIndex,
+			record.angle != 0.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " <file.journal> [threads]"
+			<< std::endl;
+		return EXIT_FAILURE;
+	}
+
+	MatchJournal matchJournal;
+
+	if (!matchJournal.open(argv[1]))
+		return EXIT_FAILURE;
+
+	// As many threads as the server uses by default
+	TaskScheduler taskScheduler((argc > 2) ? std::max(1, atoi(argv[2])) : 0);
+
+	ReplayNetworkInterface networkInterface;
+
+	Game game(&networkInterface);
+	game.setTaskScheduler(&taskScheduler);
+	game.load(matchJournal.levelNumber());
+
+	uint32_t numberOfSteps = matchJournal.numberOfSteps();
+	float stepLength = matchJournal.stepLength();
+
+	uint64_t proceedTime = 0;
+	uint64_t maximalProceedTime = 0;
+	uint64_t synchronizeTime = 0;
+
+	unsigned int nextRecord = 0;
+
+	for (uint32_t step = 0; step < numberOfSteps; step++)
+	{
+		// Input is applied between the steps, like in the server's ticks
+		while (nextRecord < matchJournal.numberOfRecords()
+			   && matchJournal.record(nextRecord).step <= step)
+			apply(game, matchJournal.record(nextRecord++));
+
+		uint64_t start = Clock::microseconds();
+
+		game.proceed(stepLength);
+
+		uint64_t synchronizeStart = Clock::microseconds();
+
+		game.synchronize(ID_ALL_CLIENTS);
+
+		uint64_t end = Clock::microseconds();
+
+		proceedTime += synchronizeStart - start;
+		maximalProceedTime = std::max(maximalProceedTime,
+			synchronizeStart - start);
+		synchronizeTime += end - synchronizeStart;
+	}
+
+	double steps = std::max(1u, numberOfSteps);
+	double wallTime = (proceedTime + synchronizeTime) / 1000000.0;
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< "level " << matchJournal.levelNumber() << ", "
+		<< numberOfSteps << " steps (" << numberOfSteps * stepLength
+		<< " s), " << matchJournal.numberOfRecords() << " records, "
+		<< game.numberOfUnits() << " units, "
+		<< taskScheduler.numberOfThreads() << " thread(s)" << std::endl
+		<< "proceed:     " << proceedTime / steps << " us/step (max "
+		<< maximalProceedTime << ")" << std::endl
+		<< "synchronize: " << synchronizeTime / steps << " us/step, "
+		<< networkInterface.numberOfBytes / steps << " bytes/step in "
+		<< networkInterface.numberOfMessages / steps << " messages"
+		<< std::endl
+		<< "replayed in " << std::setprecision(3) << wallTime << " s ("
+		<< std::setprecision(0) << numberOfSteps * stepLength
+			/ std::max(wallTime, 1e-6) << "x real time)" << std::endl
+		<< "checksum:    " << std::hex << std::setw(8) << std::setfill('0')
+		<< game.checksum() << std::endl;
+
+	return EXIT_SUCCESS;
+}
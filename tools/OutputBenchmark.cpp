@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Output benchmark
+//
+// Measures the cost per frame of producing the projector image at several
+// output resolutions, without camera or window: rendering the game image,
+// warping it into the output image (only the changed regions, as the
+// application does, and completely for comparison) and converting it to gray.
+// The units are moved by random input, so each frame has something to draw.
+//
+// Usage: output-benchmark [level] [frames] [resolution...]
+//
+// Resolutions are given as <width>x<height>, e. g. 1920x1080.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "../uist-game/Game.h"
+#include "../uist-game/Clock.h"
+#include "../uist-game/LevelFile.h"
+#include "../uist-game/Logging.h"
+#include "../ProjectorWarp.h"
+
+// One simulation step per frame of a 60 Hz projector
+const float STEP_LENGTH = 1.0f / 60.0f;
+
+// Frames between two rounds of random input
+const unsigned int DECISION_INTERVAL = 15;
+
+// Size of the wizard image the default calibration is clicked in
+const float WIZARD_WIDTH = 640.0f;
+const float WIZARD_HEIGHT = 480.0f;
+
+const float PI = 3.14159265f;
+
+struct FrameCost
+{
+	double render;
+	double warp;
+	double fullWarp;
+	double convert;
+	double dirtyFraction;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void moveRandomly(Game &game, boost::random::mt19937 &randomGenerator)
+{
+	boost::random::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+	unsigned int numberOfUnits = std::min(256u, game.numberOfUnits());
+
+	for (PlayerID playerID = ID_FIRST_CLIENT; playerID <= ID_FIRST_CLIENT + 1;
+		 playerID++)
+	{
+		for (unsigned int i = 0; i < numberOfUnits; i++)
+			game.applyMove(playerID, (uint8_t)i,
+				2.0f * PI * uniform(randomGenerator), uniform(randomGenerator));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FrameCost measure(int levelNumber, unsigned int frames, cv::Size outputSize)
+{
+	// The default calibration (the field 1:1 in the top left corner of the
+	// wizard image), scaled to the output resolution
+	cv::Mat homography = cv::Mat::eye(3, 3, CV_64F);
+	homography.at<double>(0, 0) = outputSize.width / WIZARD_WIDTH;
+	homography.at<double>(1, 1) = outputSize.height / WIZARD_HEIGHT;
+
+	cv::Mat gameImage(480, 480, CV_8UC3);
+	cv::Mat outputImage(outputSize, CV_8UC3);
+	cv::Mat fullOutputImage(outputSize, CV_8UC3);
+	cv::Mat grayImage;
+
+	ProjectorWarp projectorWarp;
+
+	// The same input for each resolution
+	boost::random::mt19937 randomGenerator(levelNumber);
+
+	Game game(NULL);
+	game.load(levelNumber);
+	game.start();
+
+	uint64_t renderTime = 0;
+	uint64_t warpTime = 0;
+	uint64_t fullWarpTime = 0;
+	uint64_t convertTime = 0;
+	double dirtyArea = 0.0;
+
+	for (unsigned int frame = 0; frame < frames; frame++)
+	{
+		if (frame % DECISION_INTERVAL == 0)
+			moveRandomly(game, randomGenerator);
+
+		game.proceed(STEP_LENGTH);
+
+		uint64_t start = Clock::microseconds();
+
+		game.render(gameImage);
+
+		uint64_t renderEnd = Clock::microseconds();
+
+		projectorWarp.addGameRects(game.dirtyRects());
+		projectorWarp.warp(gameImage, homography, outputImage);
+
+		uint64_t warpEnd = Clock::microseconds();
+
+		cv::warpPerspective(gameImage, fullOutputImage, homography,
+			outputSize, cv::INTER_LINEAR);
+
+		uint64_t fullWarpEnd = Clock::microseconds();
+
+		cv::cvtColor(outputImage, grayImage, cv::COLOR_BGR2GRAY);
+
+		uint64_t end = Clock::microseconds();
+
+		// The first frame is drawn completely
+		if (frame == 0)
+			continue;
+
+		renderTime += renderEnd - start;
+		warpTime += warpEnd - renderEnd;
+		fullWarpTime += fullWarpEnd - warpEnd;
+		convertTime += end - fullWarpEnd;
+
+		const std::vector<cv::Rect> &dirtyRects = game.dirtyRects();
+
+		for (unsigned int i = 0; i < dirtyRects.size(); i++)
+			dirtyArea += dirtyRects[i].area();
+	}
+
+	double measuredFrames = frames - 1;
+
+	FrameCost frameCost;
+	frameCost.render = renderTime / measuredFrames / 1000.0;
+	frameCost.warp = warpTime / measuredFrames / 1000.0;
+	frameCost.fullWarp = fullWarpTime / measuredFrames / 1000.0;
+	frameCost.convert = convertTime / measuredFrames / 1000.0;
+	frameCost.dirtyFraction = dirtyArea / measuredFrames
+		/ (gameImage.cols * gameImage.rows);
+
+	return frameCost;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	int levelNumber = (argc > 1) ? atoi(argv[1]) : 1;
+	unsigned int frames = (argc > 2) ? std::max(2, atoi(argv[2])) : 600;
+
+	std::vector<cv::Size> outputSizes;
+
+	for (int i = 3; i < argc; i++)
+	{
+		int width = 0;
+		int height = 0;
+
+		if (sscanf(argv[i], "%dx%d", &width, &height) != 2 || width <= 0
+			|| height <= 0)
+		{
+			std::cerr << "Usage: " << argv[0]
+				<< " [level] [frames] [resolution...]" << std::endl
+				<< "Resolutions as <width>x<height>, e. g. 1920x1080"
+				<< std::endl;
+			return EXIT_FAILURE;
+		}
+
+		outputSizes.push_back(cv::Size(width, height));
+	}
+
+	if (outputSizes.empty())
+	{
+		outputSizes.push_back(cv::Size(640, 480));
+		outputSizes.push_back(cv::Size(1280, 720));
+		outputSizes.push_back(cv::Size(1920, 1080));
+		outputSizes.push_back(cv::Size(3840, 2160));
+	}
+
+	if (LevelFile::fileName(levelNumber).empty())
+	{
+		std::cerr << "There is no level " << levelNumber << " in "
+			<< LevelFile::s_directory << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Each resolution would log loading the level and its end
+	Logging::setLevel(Logging::Level::LEVEL_WARNING);
+
+	std::cout << "level " << levelNumber << ", " << frames
+		<< " frames per resolution, ms per frame" << std::endl << std::endl
+		<< "resolution    render      warp  full warp      gray   dirty"
+		<< std::endl;
+
+	for (unsigned int i = 0; i < outputSizes.size(); i++)
+	{
+		FrameCost frameCost = measure(levelNumber, frames, outputSizes[i]);
+
+		std::stringstream resolution;
+		resolution << outputSizes[i].width << "x" << outputSizes[i].height;
+
+		std::cout << std::setw(10) << std::left << resolution.str()
+			<< std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << frameCost.render
+			<< std::setw(10) << frameCost.warp
+			<< std::setw(11) << frameCost.fullWarp
+			<< std::setw(10) << frameCost.convert
+			<< std::setw(7) << std::setprecision(0)
+			<< 100.0 * frameCost.dirtyFraction << "%" << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
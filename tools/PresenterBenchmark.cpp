@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Presenter benchmark
+//
+// Feeds the Presenter frames faster (or slower) than its refresh rate, without
+// camera or window, and checks that it shows at most one frame per refresh, in
+// the order they were submitted, and drops the rest. Each frame carries its
+// number in the first pixels; showing a frame only sleeps for the given time,
+// like a window system that takes a while to update the window.
+//
+// Usage: presenter-benchmark [refresh rate] [frame rate] [seconds] [present ms]
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+#include <boost/thread/thread.hpp>
+
+#include "../Presenter.h"
+#include "../uist-game/Clock.h"
+
+// Same size as the application's default output
+const int FRAME_WIDTH = 640;
+const int FRAME_HEIGHT = 480;
+
+struct PresentedFrames
+{
+	double presentDuration;
+	int lastNumber;
+	unsigned int outOfOrder;
+};
+
+PresentedFrames presentedFrames;
+
+////////////////////////////////////////////////////////////////////////////////
+
+int frameNumber(const cv::Mat &image)
+{
+	int number;
+	memcpy(&number, image.ptr<uint8_t>(0), sizeof(number));
+
+	return number;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void setFrameNumber(cv::Mat &image, int number)
+{
+	memcpy(image.ptr<uint8_t>(0), &number, sizeof(number));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Called on the presenter thread
+void present(const cv::Mat &image)
+{
+	int number = frameNumber(image);
+
+	if (number <= presentedFrames.lastNumber)
+		presentedFrames.outOfOrder++;
+
+	presentedFrames.lastNumber = number;
+
+	boost::this_thread::sleep(boost::posix_time::microseconds(
+		(boost::int64_t)(presentedFrames.presentDuration * 1000.0)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	double refreshRate = (argc > 1) ? atof(argv[1]) : 60.0;
+	double frameRate = (argc > 2) ? atof(argv[2]) : 200.0;
+	double seconds = (argc > 3) ? atof(argv[3]) : 2.0;
+	presentedFrames.presentDuration = (argc > 4) ? atof(argv[4]) : 5.0;
+	presentedFrames.lastNumber = -1;
+	presentedFrames.outOfOrder = 0;
+
+	if (refreshRate <= 0.0 || frameRate <= 0.0 || seconds <= 0.0
+		|| presentedFrames.presentDuration < 0.0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [refresh rate] [frame rate]"
+			<< " [seconds] [present ms]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Presenter presenter(&present, refreshRate);
+	presenter.start();
+
+	cv::Mat image(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC3, cv::Scalar(0, 0, 0));
+
+	unsigned int numberOfFrames = (unsigned int)(frameRate * seconds + 0.5);
+	uint64_t frameInterval = (uint64_t)(1000000.0 / frameRate);
+
+	uint64_t start = Clock::microseconds();
+
+	for (unsigned int i = 0; i < numberOfFrames; i++)
+	{
+		setFrameNumber(image, (int)i);
+		presenter.submit(image);
+
+		// Submitted on a fixed schedule, like frames from the camera
+		uint64_t nextFrameTime = start + (i + 1) * frameInterval;
+		uint64_t now = Clock::microseconds();
+
+		if (now < nextFrameTime)
+			boost::this_thread::sleep(boost::posix_time::microseconds(
+				(boost::int64_t)(nextFrameTime - now)));
+	}
+
+	double wallTime = (Clock::microseconds() - start) / 1000000.0;
+
+	presenter.stop();
+
+	unsigned int shownFrames = presenter.presentedFrames();
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< numberOfFrames << " frames submitted at " << frameRate
+		<< " fps to a " << refreshRate << " Hz presenter, "
+		<< presentedFrames.presentDuration << " ms to show a frame"
+		<< std::endl
+		<< "presented: " << shownFrames << " (" << shownFrames / wallTime
+		<< "/s), last frame " << presentedFrames.lastNumber << std::endl
+		<< "dropped:   " << presenter.droppedFrames() << std::endl
+		<< "latency:   " << std::setprecision(2) << presenter.latency()
+		<< " ms" << std::endl
+		<< "order:     " << (presentedFrames.outOfOrder ? "WRONG" : "ok")
+		<< std::endl;
+
+	return presentedFrames.outOfOrder ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Simulation benchmark
+//
+// Measures the cost of one server simulation step (Game::proceed) for growing
+// numbers of units, without any network or camera. The time per unit should
+// stay about constant if the simulation scales linearly. Each count is
+// measured on one thread and split across all cores.
+//
+// Usage: simulation-benchmark [steps] [number of units...]
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "../uist-game/Game.h"
+#include "../uist-game/Clock.h"
+#include "../uist-game/TaskScheduler.h"
+
+// Same step length as the game server
+const float STEP_LENGTH = 0.02f;
+
+const float FIELD_SIZE = 480.0f;
+
+////////////////////////////////////////////////////////////////////////////////
+
+double measure(unsigned int numberOfUnits, unsigned int steps,
+	TaskScheduler *taskScheduler)
+{
+	Game game(NULL);
+	game.setTaskScheduler(taskScheduler);
+	game.load(1);
+
+	srand(numberOfUnits);
+
+	// Half sheep, half hunters, spread over the whole field
+	for (unsigned int i = 0; i < numberOfUnits; i++)
+	{
+		bool isHunting = (i % 2 == 1);
+
+		game.addUnit(isHunting ? ID_FIRST_CLIENT + 1 : ID_FIRST_CLIENT,
+			(uint8_t)(i / 2 + 1),
+			FIELD_SIZE * rand() / RAND_MAX, FIELD_SIZE * rand() / RAND_MAX,
+			isHunting);
+	}
+
+	game.start();
+
+	// Warm up the caches and let the first catches happen
+	for (unsigned int i = 0; i < 10; i++)
+		game.proceed(STEP_LENGTH);
+
+	uint64_t start = Clock::microseconds();
+
+	for (unsigned int i = 0; i < steps; i++)
+		game.proceed(STEP_LENGTH);
+
+	return (double)(Clock::microseconds() - start) / steps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	unsigned int steps = 200;
+	std::vector<unsigned int> unitCounts;
+
+	if (argc > 1)
+		steps = std::max(1, atoi(argv[1]));
+
+	for (int i = 2; i < argc; i++)
+		unitCounts.push_back(atoi(argv[i]));
+
+	if (unitCounts.empty())
+	{
+		unitCounts.push_back(10);
+		unitCounts.push_back(100);
+		unitCounts.push_back(1000);
+		unitCounts.push_back(10000);
+	}
+
+	TaskScheduler taskScheduler;
+
+	std::vector<TaskScheduler *> taskSchedulers;
+	taskSchedulers.push_back(NULL);
+
+	if (taskScheduler.numberOfThreads() > 1)
+		taskSchedulers.push_back(&taskScheduler);
+
+	std::cout << std::setw(8) << "units" << std::setw(9) << "threads"
+		<< std::setw(14) << "us/step" << std::setw(14) << "ns/unit"
+		<< std::endl;
+
+	for (unsigned int i = 0; i < unitCounts.size(); i++)
+	{
+		for (unsigned int j = 0; j < taskSchedulers.size(); j++)
+		{
+			double stepTime = measure(unitCounts[i], steps, taskSchedulers[j]);
+
+			std::cout << std::fixed << std::setprecision(1)
+				<< std::setw(8) << unitCounts[i]
+				<< std::setw(9) << (taskSchedulers[j]
+					? taskSchedulers[j]->numberOfThreads() : 1)
+				<< std::setw(14) << stepTime
+				<< std::setw(14) << stepTime * 1000.0 / unitCounts[i]
+				<< std::endl;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Swarm generator
+//
+// Writes a binary level with many randomly placed units and obstacles, for
+// trying out and measuring the game with swarms. Sheep start in the upper part
+// of the field, hunters in the lower part and the obstacles in between.
+//
+// Usage: swarm-generator <output.level> [units] [obstacles] [seed]
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "../uist-game/LevelFile.h"
+
+const float FIELD_SIZE = 480.0f;
+
+// Keeps the units away from the walls
+const float MARGIN = 16.0f;
+
+const float MINIMAL_OBSTACLE_RADIUS = 4.0f;
+const float MAXIMAL_OBSTACLE_RADIUS = 16.0f;
+
+////////////////////////////////////////////////////////////////////////////////
+
+float random(float minimum, float maximum)
+{
+	return minimum + (maximum - minimum) * rand() / RAND_MAX;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0]
+			<< " <output.level> [units] [obstacles] [seed]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	int numberOfUnits = (argc > 2) ? std::max(0, atoi(argv[2])) : 1000;
+	int numberOfObstacles = (argc > 3) ? std::max(0, atoi(argv[3])) : 100;
+
+	srand((argc > 4) ? atoi(argv[4]) : 1);
+
+	LevelFile levelFile;
+
+	// Half sheep, half hunters
+	for (int i = 0; i < numberOfUnits; i++)
+	{
+		bool isHunting = (i % 2 == 1);
+
+		float y = isHunting
+			? random(FIELD_SIZE * 0.7f, FIELD_SIZE * 0.9f)
+			: random(MARGIN, FIELD_SIZE * 0.25f);
+
+		levelFile.addUnit(random(MARGIN, FIELD_SIZE - MARGIN), y, isHunting);
+	}
+
+	for (int i = 0; i < numberOfObstacles; i++)
+	{
+		levelFile.addObstacle(random(0.0f, FIELD_SIZE),
+			random(FIELD_SIZE * 0.3f, FIELD_SIZE * 0.65f),
+			random(MINIMAL_OBSTACLE_RADIUS, MAXIMAL_OBSTACLE_RADIUS));
+	}
+
+	if (!levelFile.save(argv[1]))
+	{
+		std::cerr << "Could not write " << argv[1] << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::cout << argv[1] << ": " << levelFile.numberOfUnits() << " units, "
+		<< levelFile.numberOfObstacles() << " obstacles" << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,22 @@
+#include "Clock.h"
+
+#include <boost/chrono.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Clock
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Clock::microseconds()
+{
+	return boost::chrono::duration_cast<boost::chrono::microseconds>(
+		boost::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Clock::seconds()
+{
+	return microseconds() / 1000000.0;
+}
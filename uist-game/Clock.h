@@ -0,0 +1,32 @@
+#ifndef __GENERAL_CLOCK_H
+#define __GENERAL_CLOCK_H
+
+#include <boost/cstdint.hpp>
+
+/**
+ * @class Clock
+ *
+ * @brief Monotonic wall clock.
+ *
+ * Unlike boost::timer (which measures CPU time), this clock measures real time
+ * and never jumps, so it is suitable for frame and network timing.
+ */
+class Clock
+{
+	public:
+		/**
+		 * @brief Returns the current time in microseconds.
+		 *
+		 * @return Microseconds since an arbitrary, fixed point in time.
+		 */
+		static uint64_t microseconds();
+
+		/**
+		 * @brief Returns the current time in seconds.
+		 *
+		 * @return Seconds since an arbitrary, fixed point in time.
+		 */
+		static double seconds();
+};
+
+#endif
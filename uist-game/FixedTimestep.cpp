@@ -0,0 +1,67 @@
+#include "FixedTimestep.h"
+
+#include "Clock.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// FixedTimestep
+//
+////////////////////////////////////////////////////////////////////////////////
+
+FixedTimestep::FixedTimestep(double stepLength, unsigned int maximalSteps)
+{
+	m_stepLength = (uint64_t)(stepLength * 1000000.0);
+	m_maximalSteps = maximalSteps;
+
+	restart();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FixedTimestep::restart()
+{
+	m_lastTime = Clock::microseconds();
+	m_accumulator = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int FixedTimestep::advance()
+{
+	uint64_t now = Clock::microseconds();
+
+	m_accumulator += now - m_lastTime;
+	m_lastTime = now;
+
+	unsigned int steps = (unsigned int)(m_accumulator / m_stepLength);
+
+	if (steps > m_maximalSteps)
+	{
+		// Drop the time we cannot catch up with
+		steps = m_maximalSteps;
+		m_accumulator = steps * m_stepLength;
+	}
+
+	m_accumulator -= steps * m_stepLength;
+
+	return steps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double FixedTimestep::stepLength() const
+{
+	return m_stepLength / 1000000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t FixedTimestep::timeUntilNextStep() const
+{
+	uint64_t elapsed = m_accumulator + (Clock::microseconds() - m_lastTime);
+
+	if (elapsed >= m_stepLength)
+		return 0;
+
+	return m_stepLength - elapsed;
+}
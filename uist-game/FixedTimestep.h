@@ -0,0 +1,56 @@
+#ifndef __GENERAL_FIXEDTIMESTEP_H
+#define __GENERAL_FIXEDTIMESTEP_H
+
+#include <boost/cstdint.hpp>
+
+/**
+ * @class FixedTimestep
+ *
+ * @brief Splits elapsed wall time into simulation steps of constant length.
+ *
+ * Elapsed time (measured with Clock) is collected in an accumulator, from
+ * which whole steps are taken. The remainder is kept for the next call, so the
+ * simulation advances exactly as fast as real time on average, independently
+ * of how regularly it is called.
+ */
+class FixedTimestep
+{
+	public:
+		/**
+		 * @brief Creates a timestep.
+		 *
+		 * @param stepLength - Simulated time per step in seconds.
+		 * @param maximalSteps - Upper limit of steps per advance() call. Time
+		 *     beyond that is dropped, so a stalled process does not try to
+		 *     catch up forever.
+		 */
+		FixedTimestep(double stepLength, unsigned int maximalSteps = 5);
+
+		/** @brief Forgets all time elapsed so far. */
+		void restart();
+
+		/**
+		 * @brief Collects the time elapsed since the last call.
+		 *
+		 * @return Number of steps that are due now.
+		 */
+		unsigned int advance();
+
+		double stepLength() const;
+
+		/**
+		 * @brief Returns the wall time until the next step is due.
+		 *
+		 * @return Time in microseconds.
+		 */
+		uint64_t timeUntilNextStep() const;
+
+	protected:
+		uint64_t m_stepLength;
+		unsigned int m_maximalSteps;
+
+		uint64_t m_lastTime;
+		uint64_t m_accumulator;
+};
+
+#endif
@@ -8,6 +8,15 @@ class GameUnit;
 typedef boost::shared_ptr<GameUnit> GameUnitPtr;
 typedef std::vector<GameUnitPtr> GameUnits;
 
+class UnitStates;
+class TaskScheduler;
+
+class GameUnitMessage;
+typedef boost::shared_ptr<GameUnitMessage> GameUnitMessagePtr;
+
+class InputBatch;
+typedef boost::shared_ptr<InputBatch> InputBatchPtr;
+
 class PlayerProfile;
 typedef boost::shared_ptr<PlayerProfile> PlayerProfilePtr;
 typedef std::vector<PlayerProfilePtr> PlayerProfiles;
@@ -19,6 +28,10 @@ class GameObstacle;
 typedef boost::shared_ptr<GameObstacle> GameObstaclePtr;
 typedef std::vector<GameObstaclePtr> GameObstacles;
 
+class GameRoom;
+typedef boost::shared_ptr<GameRoom> GameRoomPtr;
+typedef std::vector<GameRoomPtr> GameRooms;
+
 class GameNetworkServer;
 class GameNetworkClient;
 class GameNetworkInterface;
@@ -1,15 +1,47 @@
 #include "Game.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include <boost/bind.hpp>
+#include <boost/thread/lock_guard.hpp>
 
 #include "GameNetworkInterface.h"
 #include "GameUnit.h"
+#include "GameUnitMessage.h"
 #include "GameObstacle.h"
-#include "MoveRequest.h"
-#include "HighlightRequest.h"
+#include "InputBatch.h"
+#include "LevelFile.h"
 #include "NewPlayerID.h"
+#include "Clock.h"
 #include "Logging.h"
 
+// Smaller changes of a move request are not sent to the server
+const float INPUT_ANGLE_TOLERANCE = 0.05f;
+const float INPUT_STRENGTH_TOLERANCE = 0.02f;
+
+// Multiple of 4, so that the SIMD kernels group the units the same way as
+// without splitting
+unsigned int Game::s_unitsPerTask = 1024;
+
+// Edge length of the square playing field
+const float FIELD_SIZE = 480.0f;
+
+// Beyond a round-trip time of this, own units lag behind the input again
+float Game::s_maximalPrediction = 0.5f;
+
+// Longer frames are replayed in several steps, like the server's ticks
+const float MAXIMAL_PREDICTION_STEP = 1.0f / 60.0f;
+
+// Sent input batches remembered to match the server's acknowledgements
+const unsigned int MAXIMAL_SENT_INPUTS = 64;
+
+const char STATE_MAGIC[4] = {'F', 'S', 'G', 'S'};
+
+// Edge length of the squares the image is repainted in, about two units
+const int TILE_SIZE = 32;
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Game
@@ -17,6 +49,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 Game::Game(GameNetworkInterface *gameNetworkInterface)
+	: m_sheepGrid(FIELD_SIZE, FIELD_SIZE, 2 * GameUnit::s_radius)
 {
 	m_gameNetworkInterface = gameNetworkInterface;
 
@@ -24,9 +57,28 @@ Game::Game(GameNetworkInterface *gameNetworkInterface)
 
 	m_hasStarted = false;
 	m_hasFinished = false;
+	m_elapsedTime = 0.0;
+	m_simulationTime = 0.0;
 	m_lastUnitTime = -1.0f;
+	m_haveUnitsChanged = false;
+	m_taskScheduler = NULL;
+
+	m_inputSequence = 0;
+	m_acknowledgedSequence = 0;
+	m_acknowledgedAge = 0.0;
+	m_predictionHorizon = 0.0;
+
+	m_obstacleField.reset(FIELD_SIZE, FIELD_SIZE);
+	m_isBackgroundValid = false;
+	m_renderTarget = NULL;
+
+	m_inputBatch = InputBatchPtr(new InputBatch(m_gameNetworkInterface));
+	m_sentUnitMessage = GameUnitMessagePtr(
+		new GameUnitMessage(m_gameNetworkInterface));
+	m_receivedUnitMessage = GameUnitMessagePtr(new GameUnitMessage(NULL));
 
-	initializeMessageHandlers();
+	if (m_gameNetworkInterface)
+		initializeMessageHandlers();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,446 +107,1350 @@ void Game::load(int levelNumber)
 {
 	reset();
 
-	std::vector<cv::Point> unitPositionsPlayer1;
-	std::vector<cv::Point> unitPositionsPlayer2;
-	std::vector<cv::Point> obstaclePositions;
-	std::vector<float> obstacleRadii;
-
-	switch (levelNumber)
-	{
-		case 2:
-			unitPositionsPlayer1.push_back(cv::Point(20, 96));
-			unitPositionsPlayer1.push_back(cv::Point(100, 80));
-			unitPositionsPlayer1.push_back(cv::Point(180, 64));
-			unitPositionsPlayer1.push_back(cv::Point(380, 80));
-			unitPositionsPlayer1.push_back(cv::Point(460, 96));
-			unitPositionsPlayer2.push_back(cv::Point(20, 360));
-			unitPositionsPlayer2.push_back(cv::Point(100, 344));
-			unitPositionsPlayer2.push_back(cv::Point(300, 328));
-			unitPositionsPlayer2.push_back(cv::Point(380, 344));
-			unitPositionsPlayer2.push_back(cv::Point(460, 360));
-			obstaclePositions.push_back(cv::Point(240, 240));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(0, 0));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(0, 480));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(480, 0));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(480, 480));
-			obstacleRadii.push_back(50);
-			break;
-
-		case 3:
-			unitPositionsPlayer1.push_back(cv::Point(20, 96));
-			unitPositionsPlayer1.push_back(cv::Point(60, 80));
-			unitPositionsPlayer1.push_back(cv::Point(100, 64));
-			unitPositionsPlayer1.push_back(cv::Point(420, 80));
-			unitPositionsPlayer1.push_back(cv::Point(460, 96));
-			unitPositionsPlayer2.push_back(cv::Point(20, 360));
-			unitPositionsPlayer2.push_back(cv::Point(60, 344));
-			unitPositionsPlayer2.push_back(cv::Point(380, 328));
-			unitPositionsPlayer2.push_back(cv::Point(420, 344));
-			unitPositionsPlayer2.push_back(cv::Point(460, 360));
-			obstaclePositions.push_back(cv::Point(240, 0));
-			obstacleRadii.push_back(75);
-			obstaclePositions.push_back(cv::Point(240, 480));
-			obstacleRadii.push_back(75);
-			obstaclePositions.push_back(cv::Point(240, 80));
-			obstacleRadii.push_back(60);
-			obstaclePositions.push_back(cv::Point(240, 400));
-			obstacleRadii.push_back(60);
-			obstaclePositions.push_back(cv::Point(0, 240));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(480, 240));
-			obstacleRadii.push_back(50);
-			obstaclePositions.push_back(cv::Point(160, 240));
-			obstacleRadii.push_back(30);
-			obstaclePositions.push_back(cv::Point(320, 240));
-			obstacleRadii.push_back(30);
-			break;
-
-		case 4:
-			unitPositionsPlayer1.push_back(cv::Point(340, 96));
-			unitPositionsPlayer1.push_back(cv::Point(370, 80));
-			unitPositionsPlayer1.push_back(cv::Point(400, 64));
-			unitPositionsPlayer1.push_back(cv::Point(430, 80));
-			unitPositionsPlayer1.push_back(cv::Point(460, 96));
-			unitPositionsPlayer2.push_back(cv::Point(20, 360));
-			unitPositionsPlayer2.push_back(cv::Point(50, 344));
-			unitPositionsPlayer2.push_back(cv::Point(80, 328));
-			unitPositionsPlayer2.push_back(cv::Point(110, 344));
-			unitPositionsPlayer2.push_back(cv::Point(140, 360));
-			obstaclePositions.push_back(cv::Point(40, 40));
-			obstacleRadii.push_back(100);
-			obstaclePositions.push_back(cv::Point(440, 440));
-			obstacleRadii.push_back(100);
-			obstaclePositions.push_back(cv::Point(240, 40));
-			obstacleRadii.push_back(75);
-			obstaclePositions.push_back(cv::Point(240, 440));
-			obstacleRadii.push_back(75);
-			obstaclePositions.push_back(cv::Point(200, 200));
-			obstacleRadii.push_back(30);
-			obstaclePositions.push_back(cv::Point(280, 280));
-			obstacleRadii.push_back(30);
-			break;
-
-		default:
-			unitPositionsPlayer1.push_back(cv::Point(20, 96));
-			unitPositionsPlayer1.push_back(cv::Point(60, 96));
-			unitPositionsPlayer1.push_back(cv::Point(100, 96));
-			unitPositionsPlayer1.push_back(cv::Point(420, 96));
-			unitPositionsPlayer1.push_back(cv::Point(460, 96));
-			unitPositionsPlayer2.push_back(cv::Point(20, 360));
-			unitPositionsPlayer2.push_back(cv::Point(60, 360));
-			unitPositionsPlayer2.push_back(cv::Point(380, 360));
-			unitPositionsPlayer2.push_back(cv::Point(420, 360));
-			unitPositionsPlayer2.push_back(cv::Point(460, 360));
-			obstaclePositions.push_back(cv::Point(44, 192));
-			obstacleRadii.push_back(44);
-			obstaclePositions.push_back(cv::Point(44 + 88, 192));
-			obstacleRadii.push_back(44);
-			obstaclePositions.push_back(cv::Point(436, 192));
-			obstacleRadii.push_back(44);
-			obstaclePositions.push_back(cv::Point(436 - 88, 192));
-			obstacleRadii.push_back(44);
-			obstaclePositions.push_back(cv::Point(216, 272));
-			obstacleRadii.push_back(12);
-			obstaclePositions.push_back(cv::Point(264, 272));
-			obstacleRadii.push_back(12);
-			break;
-	}
-
-	int unitNumber = 1;
-
-	for (std::vector<cv::Point>::iterator unitPosition = unitPositionsPlayer1.begin();
-		 unitPosition != unitPositionsPlayer1.end(); unitPosition++)
-	{
-		GameUnitPtr newGameUnit(new GameUnit(m_gameNetworkInterface));
-		newGameUnit->generateMessageID();
-		newGameUnit->setNumber(unitNumber++);
-		newGameUnit->setOwner(ID_FIRST_CLIENT);
-		newGameUnit->setPosition((*unitPosition).x, (*unitPosition).y);
-		newGameUnit->setHunting(false);
-		m_gameUnits.push_back(newGameUnit);
-	}
-
-	unitNumber = 1;
-
-	for (std::vector<cv::Point>::iterator unitPosition = unitPositionsPlayer2.begin();
-		 unitPosition != unitPositionsPlayer2.end(); unitPosition++)
-	{
-		GameUnitPtr newGameUnit(new GameUnit(m_gameNetworkInterface));
-		newGameUnit->generateMessageID();
-		newGameUnit->setNumber(unitNumber++);
-		newGameUnit->setOwner(ID_FIRST_CLIENT + 1);
-		newGameUnit->setPosition((*unitPosition).x, (*unitPosition).y);
-		newGameUnit->setHunting(true);
-		m_gameUnits.push_back(newGameUnit);
-	}
-
-	for (unsigned int i = 0; i < obstaclePositions.size(); i++)
+	std::string fileName = LevelFile::fileName(levelNumber);
+
+	if (fileName.empty())
+	{
+		std::stringstream error;
+		error << "There is no level " << levelNumber << " in "
+			  << LevelFile::s_directory << ".";
+		Logging::error(error.str());
+
+		return;
+	}
+
+	LevelFile levelFile;
+
+	if (!levelFile.open(fileName))
+		return;
+
+	// Copy the records straight into the simulation arrays
+	unsigned int numberOfUnits = levelFile.numberOfUnits();
+	const LevelFile::Unit *units = levelFile.units();
+
+	MessageID firstMessageID = Message::reserveMessageIDs(numberOfUnits);
+
+	if (firstMessageID == MESSAGE_ID_NONE)
+		return;
+
+	unsigned int firstIndex = m_unitStates.append(numberOfUnits,
+		firstMessageID);
+
+	for (unsigned int i = 0; i < numberOfUnits; i++)
+	{
+		unsigned int index = firstIndex + i;
+
+		m_unitStates.x[index] = units[i].x;
+		m_unitStates.y[index] = units[i].y;
+		m_unitStates.number[index] = units[i].number;
+
+		// The first player guides the sheep, the second one the hunters
+		if (units[i].isHunting)
+		{
+			m_unitStates.owner[index] = ID_FIRST_CLIENT + 1;
+			m_unitStates.setFlags(index, m_unitStates.flags[index]
+				| UnitStates::UNIT_HUNTING);
+		}
+		else
+		{
+			m_unitStates.owner[index] = ID_FIRST_CLIENT;
+		}
+
+		addToOwnerTable(index);
+	}
+
+	unsigned int numberOfObstacles = levelFile.numberOfObstacles();
+	const LevelFile::Obstacle *obstacles = levelFile.obstacles();
+
+	m_gameObstacles.reserve(numberOfObstacles);
+
+	for (unsigned int i = 0; i < numberOfObstacles; i++)
 	{
 		GameObstaclePtr newGameObstacle(new GameObstacle(m_gameNetworkInterface));
 		newGameObstacle->generateMessageID();
-		newGameObstacle->setPosition(obstaclePositions[i].x,
-									 obstaclePositions[i].y);
-		newGameObstacle->setRadius(obstacleRadii[i]);
+		newGameObstacle->setPosition(obstacles[i].x, obstacles[i].y);
+		newGameObstacle->setRadius(obstacles[i].radius);
 		m_gameObstacles.push_back(newGameObstacle);
+
+		m_obstacleIndexByID.insert(newGameObstacle->messageID(),
+			m_gameObstacles.size() - 1);
+
+		m_obstacleField.addObstacle(obstacles[i].x, obstacles[i].y,
+			obstacles[i].radius);
 	}
 
+	m_isBackgroundValid = false;
+
 	std::stringstream info;
-	info << "Loaded level " << (int)levelNumber << ".";
+	info << "Loaded level " << levelNumber << " (" << numberOfUnits
+		 << " units, " << numberOfObstacles << " obstacles).";
 	Logging::info(info.str());
-
-	m_timer.restart();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::reset()
+unsigned int Game::addUnit(PlayerID owner, uint8_t number, float x, float y,
+	bool isHunting)
 {
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		m_gameUnits[i] = GameUnitPtr();
+	GameUnit newGameUnit(&m_unitStates,
+		m_unitStates.add(Message::reserveMessageIDs(1)));
+	newGameUnit.setNumber(number);
+	newGameUnit.setOwner(owner);
+	newGameUnit.setPosition(x, y);
+	newGameUnit.setHunting(isHunting);
 
-	m_gameUnits.clear();
+	addToOwnerTable(newGameUnit.index());
 
-	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
-		m_gameObstacles[i] = GameObstaclePtr();
+	return newGameUnit.index();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-	m_gameObstacles.clear();
+unsigned int Game::numberOfUnits() const
+{
+	return m_unitStates.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::render(cv::Mat &image)
+void Game::reset()
 {
-	cv::rectangle(image, cv::Point(0, 0), cv::Point(480, 480),
-				  cv::Scalar(32, 32, 32), CV_FILLED);
+	{
+		boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
 
-	cv::rectangle(image, cv::Point(0, 472), cv::Point(480, 480),
-				  cv::Scalar(32, 128, 64), CV_FILLED);
+		m_unitStates.clear();
+		m_unitsByOwner.clear();
+		m_snapshotBuffer.clear();
 
-	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
-		m_gameObstacles[i]->render(image);
+		m_predictedStates.clear();
+		m_predictedFrames.clear();
+		m_sentInputs.clear();
+
+		m_acknowledgedSequence = 0;
+		m_acknowledgedAge = 0.0;
+		m_predictionHorizon = 0.0;
+
+		for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+			m_gameObstacles[i] = GameObstaclePtr();
 
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		m_gameUnits[i]->render(image);
+		m_gameObstacles.clear();
+		m_obstacleIndexByID.clear();
+
+		m_obstacleField.reset(FIELD_SIZE, FIELD_SIZE);
+	}
+
+	m_inputAcknowledgements.clear();
+
+	m_isBackgroundValid = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::proceed()
+void Game::render(cv::Mat &image)
 {
-	float timeDifference = m_timer.elapsed();
-	m_timer.restart();
+	// Anything but the units of the last frame in the same image is drawn
+	// completely
+	bool isRepainted = !m_isBackgroundValid || image.type() != CV_8UC3
+		|| m_background.size() != image.size()
+		|| m_background.type() != image.type()
+		|| image.data != m_renderTarget;
 
-	if (!hasStarted())
-		return;
+	if (!m_isBackgroundValid || m_background.size() != image.size()
+		|| m_background.type() != image.type())
+		renderBackground(image.size(), image.type());
+
+	m_renderTarget = image.data;
 
-	if (m_durationTimer.elapsed() > 60.0f && !hasFinished())
 	{
-		m_hasFinished = true;
+		boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
 
-		std::cout << "[Info] Game finished." << std::endl << std::endl;
+		m_renderStates = m_unitStates;
+		m_snapshotBuffer.sample(m_snapshotBuffer.presentationTime(),
+			m_renderStates.x, m_renderStates.y);
+	}
 
-		int arrivedUnits = 0;
+	// Own units are drawn where they are predicted to be, in the same order
+	unsigned int predictedIndex = 0;
 
-		for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-			if (!m_gameUnits[i]->isHunting() && m_gameUnits[i]->hasArrived()
-				&& m_gameUnits[i]->isLiving())
-				arrivedUnits++;
+	for (unsigned int i = 0; i < m_renderStates.size()
+		 && predictedIndex < m_predictedStates.size(); i++)
+	{
+		if (m_renderStates.messageID[i]
+			!= m_predictedStates.messageID[predictedIndex])
+			continue;
 
-		int survivingUnits = 0;
+		m_renderStates.x[i] = m_predictedStates.x[predictedIndex];
+		m_renderStates.y[i] = m_predictedStates.y[predictedIndex];
 
-		for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-			if (!m_gameUnits[i]->isHunting() && !m_gameUnits[i]->hasArrived()
-				&& m_gameUnits[i]->isLiving())
-				survivingUnits++;
+		predictedIndex++;
+	}
 
-		std::cout << "[Info] Sheep (blue): " << std::endl
-			<< "       " << arrivedUnits << " arrived" << std::endl
-			<< "       " << survivingUnits << " survived" << std::endl;
+	m_dirtyRects.clear();
 
-		if (m_lastUnitTime > 0)
-			std::cout << "       Last unit arrived at " << m_lastUnitTime
-				<< std::endl;
+	if (!isRepainted)
+	{
+		renderDirtyTiles(image);
+		return;
+	}
+
+	m_background.copyTo(image);
+
+	m_renderedUnits.resize(m_renderStates.size());
 
-		std::cout << std::endl << "       Score: "
-			<< (2 * arrivedUnits + survivingUnits) << std::endl;
+	for (unsigned int i = 0; i < m_renderStates.size(); i++)
+	{
+		m_unitSprites.render(image, m_renderStates, i);
+
+		m_renderedUnits[i].bounds = m_unitSprites.bounds(m_renderStates, i);
+		m_renderedUnits[i].sprite = UnitSprites::key(m_renderStates, i);
 	}
 
-	if (hasFinished())
-		return;
+	m_dirtyRects.push_back(cv::Rect(0, 0, image.cols, image.rows));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const std::vector<cv::Rect> &Game::dirtyRects() const
+{
+	return m_dirtyRects;
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
+void Game::renderDirtyTiles(cv::Mat &image)
+{
+	int columns = (image.cols + TILE_SIZE - 1) / TILE_SIZE;
+	int rows = (image.rows + TILE_SIZE - 1) / TILE_SIZE;
+
+	m_dirtyTiles.assign(columns * rows, false);
+
+	// Units that moved or changed their look dirty where they were and are
+	unsigned int numberOfUnits = std::max((unsigned int)m_renderedUnits.size(),
+		m_renderStates.size());
+
+	for (unsigned int i = 0; i < numberOfUnits; i++)
 	{
-		m_gameUnits[i]->move(timeDifference);
-		m_gameUnits[i]->reflectOnWalls();
+		RenderedUnit renderedUnit;
+		renderedUnit.sprite = 0;
 
-		if (!m_gameUnits[i]->hasArrived() && !m_gameUnits[i]->isHunting()
-			&& m_gameUnits[i]->y() >= 480 - GameUnit::s_radius)
+		if (i < m_renderStates.size())
 		{
-			m_gameUnits[i]->setArrived(true);
-
-			m_lastUnitTime = m_durationTimer.elapsed();
+			renderedUnit.bounds = m_unitSprites.bounds(m_renderStates, i);
+			renderedUnit.sprite = UnitSprites::key(m_renderStates, i);
 		}
+
+		if (i >= m_renderedUnits.size())
+			m_renderedUnits.push_back(RenderedUnit());
+		else if (m_renderedUnits[i].bounds == renderedUnit.bounds
+			&& m_renderedUnits[i].sprite == renderedUnit.sprite)
+			continue;
+
+		markDirtyTiles(m_renderedUnits[i].bounds, columns, rows);
+		markDirtyTiles(renderedUnit.bounds, columns, rows);
+
+		m_renderedUnits[i] = renderedUnit;
 	}
 
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		for (unsigned int j = 0; j < m_gameObstacles.size(); j++)
+	m_renderedUnits.resize(m_renderStates.size());
+
+	cv::Rect imageRect(0, 0, image.cols, image.rows);
+
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
 		{
-			if (!m_gameUnits[i]->collidesWith(*m_gameObstacles[j]))
+			if (!m_dirtyTiles[row * columns + column])
 				continue;
 
-			m_gameUnits[i]->separateFrom(*m_gameObstacles[j]);
+			cv::Rect tile = cv::Rect(column * TILE_SIZE, row * TILE_SIZE,
+				TILE_SIZE, TILE_SIZE) & imageRect;
+
+			cv::Mat region = image(tile);
+			m_background(tile).copyTo(region);
 		}
+	}
+
+	// Each unit is only blended into the dirty tiles, in the usual order,
+	// as blending it again into clean ones would darken its edges
+	for (unsigned int i = 0; i < m_renderStates.size(); i++)
+	{
+		const cv::Rect &bounds = m_renderedUnits[i].bounds;
 
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		for (unsigned int j = 0; j < m_gameUnits.size(); j++)
+		int firstColumn, firstRow, lastColumn, lastRow;
+
+		if (!tileRange(bounds, columns, rows, firstColumn, firstRow,
+			lastColumn, lastRow))
+			continue;
+
+		for (int row = firstRow; row <= lastRow; row++)
 		{
-			if (i == j)
-				continue;
+			for (int column = firstColumn; column <= lastColumn; column++)
+			{
+				if (!m_dirtyTiles[row * columns + column])
+					continue;
+
+				cv::Rect tile = cv::Rect(column * TILE_SIZE, row * TILE_SIZE,
+					TILE_SIZE, TILE_SIZE) & imageRect;
+
+				cv::Mat region = image(tile);
+				m_unitSprites.render(region, m_renderStates, i, tile.tl());
+			}
+		}
+	}
 
-			if (!m_gameUnits[i]->collidesWith(*m_gameUnits[j]))
+	// Runs of dirty tiles per row, joined with equal runs of the row above
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			if (!m_dirtyTiles[row * columns + column])
 				continue;
 
-			if (!m_gameUnits[i]->isHunting())
-				m_gameUnits[i]->setLiving(false);
+			int firstColumn = column;
+
+			while (column + 1 < columns
+				   && m_dirtyTiles[row * columns + column + 1])
+				column++;
+
+			cv::Rect run = cv::Rect(firstColumn * TILE_SIZE, row * TILE_SIZE,
+				(column - firstColumn + 1) * TILE_SIZE, TILE_SIZE) & imageRect;
 
-			if (!m_gameUnits[j]->isHunting())
-				m_gameUnits[j]->setLiving(false);
+			bool isJoined = false;
+
+			for (unsigned int i = 0; i < m_dirtyRects.size() && !isJoined; i++)
+			{
+				cv::Rect &dirtyRect = m_dirtyRects[i];
+
+				if (dirtyRect.x == run.x && dirtyRect.width == run.width
+					&& dirtyRect.y + dirtyRect.height == run.y)
+				{
+					dirtyRect.height += run.height;
+					isJoined = true;
+				}
+			}
+
+			if (!isJoined)
+				m_dirtyRects.push_back(run);
 		}
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::synchronize(NetworkServerSession *session)
+void Game::markDirtyTiles(const cv::Rect &rect, int columns, int rows)
 {
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		m_gameUnits[i]->synchronize(session);
+	int firstColumn, firstRow, lastColumn, lastRow;
 
-	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
-		m_gameObstacles[i]->synchronize(session);
+	if (!tileRange(rect, columns, rows, firstColumn, firstRow, lastColumn,
+		lastRow))
+		return;
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+			m_dirtyTiles[row * columns + column] = true;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::synchronize(PlayerID playerID)
+bool Game::tileRange(const cv::Rect &rect, int columns, int rows,
+	int &firstColumn, int &firstRow, int &lastColumn, int &lastRow)
 {
-	for (unsigned int i = 0; i < m_gameUnits.size(); i++)
-		m_gameUnits[i]->synchronize(playerID);
+	if (rect.width <= 0 || rect.height <= 0)
+		return false;
 
-	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
-		m_gameObstacles[i]->synchronize(playerID);
+	firstColumn = std::max(0, rect.x) / TILE_SIZE;
+	firstRow = std::max(0, rect.y) / TILE_SIZE;
+	lastColumn = std::min(columns - 1, (rect.x + rect.width - 1) / TILE_SIZE);
+	lastRow = std::min(rows - 1, (rect.y + rect.height - 1) / TILE_SIZE);
+
+	// Also false for rects left of or above the image
+	return rect.x + rect.width > 0 && rect.y + rect.height > 0
+		&& firstColumn <= lastColumn && firstRow <= lastRow;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::start()
+void Game::renderBackground(cv::Size size, int type)
 {
-	m_hasStarted = true;
+	// Set first, so obstacles received meanwhile invalidate it again
+	m_isBackgroundValid = true;
 
-	m_durationTimer.restart();
-}
+	m_background.create(size, type);
+	m_background.setTo(cv::Scalar(0, 0, 0));
 
-void Game::stop()
-{
-	m_hasStarted = false;
-	reset();
+	cv::rectangle(m_background, cv::Point(0, 0), cv::Point(480, 480),
+				  cv::Scalar(32, 32, 32), CV_FILLED);
+
+	cv::rectangle(m_background, cv::Point(0, 472), cv::Point(480, 480),
+				  cv::Scalar(32, 128, 64), CV_FILLED);
+
+	// Obstacles may be received by the network thread meanwhile
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+		m_gameObstacles[i]->render(m_background);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool Game::hasStarted() const
+void Game::proceed(float timeDifference)
 {
-	return m_hasStarted;
+	m_simulationTime += timeDifference;
+
+	if (!hasStarted())
+		return;
+
+	if (!hasFinished())
+		m_elapsedTime += timeDifference;
+
+	if (m_elapsedTime > 60.0f && !hasFinished())
+	{
+		m_hasFinished = true;
+
+		std::stringstream info;
+		info << "Game finished." << std::endl << std::endl
+			<< "       Sheep (blue): " << std::endl
+			<< "       " << arrivedUnits() << " arrived" << std::endl
+			<< "       " << survivingUnits() << " survived" << std::endl;
+
+		if (m_lastUnitTime > 0)
+			info << "       Last unit arrived at " << m_lastUnitTime
+				<< std::endl;
+
+		info << std::endl << "       Score: " << score();
+
+		Logging::info(info.str());
+	}
+
+	if (hasFinished())
+		return;
+
+	unsigned int numberOfTasks = (m_unitStates.size() + s_unitsPerTask - 1)
+		/ s_unitsPerTask;
+
+	if (m_unitTasks.size() < numberOfTasks)
+		m_unitTasks.resize(numberOfTasks);
+
+	forEachUnitTask(boost::bind(&Game::proceedUnits, this, timeDifference,
+		_1, _2));
+
+	// Applied serially, as arriving changes the score
+	for (unsigned int i = 0; i < numberOfTasks; i++)
+	{
+		const std::vector<int> &arrivedUnits = m_unitTasks[i].arrivedUnits;
+
+		for (unsigned int j = 0; j < arrivedUnits.size(); j++)
+			m_unitStates.setFlags(arrivedUnits[j],
+				m_unitStates.flags[arrivedUnits[j]] | UnitStates::UNIT_ARRIVED);
+
+		if (!arrivedUnits.empty())
+			m_lastUnitTime = m_elapsedTime;
+	}
+
+	catchSheep();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool Game::hasFinished() const
+void Game::setTaskScheduler(TaskScheduler *taskScheduler)
 {
-	return m_hasFinished;
+	m_taskScheduler = taskScheduler;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::handleNewPlayerID(MessageData messageData)
+void Game::forEachUnitTask(const TaskScheduler::RangeFunction &function)
 {
-	NewPlayerID newPlayerID(NULL);
-	newPlayerID.createFromData(messageData);
+	unsigned int numberOfUnits = m_unitStates.size();
 
-	std::cout << "[Info] New player ID received." << std::endl;
+	if (m_taskScheduler)
+	{
+		m_taskScheduler->parallelFor(numberOfUnits, s_unitsPerTask, function);
+		return;
+	}
 
-	m_ownPlayerID = newPlayerID.playerID();
+	for (unsigned int begin = 0; begin < numberOfUnits; begin += s_unitsPerTask)
+		function(begin, std::min(begin + s_unitsPerTask, numberOfUnits));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::handleGameUnit(MessageData messageData)
+void Game::proceedUnits(float timeDifference, unsigned int begin,
+	unsigned int end)
 {
-	GameUnitPtr matchingGameUnit = unitByID(messageData.messageID());
+	UnitTask &unitTask = m_unitTasks[begin / s_unitsPerTask];
 
-	if (matchingGameUnit)
-		return;
+	m_unitStates.move(timeDifference, GameUnit::s_maximalVelocity,
+		GameUnit::s_brakeFactor, begin, end);
+	m_unitStates.reflectOnWalls(GameUnit::s_radius / 2,
+		480 - GameUnit::s_radius / 2, begin, end);
 
-	GameUnitPtr newGameUnit(new GameUnit(m_gameNetworkInterface));
-	newGameUnit->createFromData(messageData);
-	m_gameUnits.push_back(newGameUnit);
+	const uint8_t arrivingFlags = UnitStates::UNIT_HUNTING
+		| UnitStates::UNIT_ARRIVED;
+
+	unitTask.arrivedUnits.clear();
+
+	for (unsigned int i = begin; i < end; i++)
+	{
+		if (!(m_unitStates.flags[i] & arrivingFlags)
+			&& m_unitStates.y[i] >= 480 - GameUnit::s_radius)
+			unitTask.arrivedUnits.push_back(i);
+	}
+
+	collideWithObstacles(m_unitStates, begin, end);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::handleGameObstacle(MessageData messageData)
+void Game::collideWithObstacles(UnitStates &unitStates, unsigned int begin,
+	unsigned int end)
 {
-	GameObstaclePtr matchingGameObstacle = obstacleByID(messageData.messageID());
-
-	if (matchingGameObstacle)
+	if (m_obstacleField.isEmpty())
 		return;
 
-	GameObstaclePtr newGameObstacle(new GameObstacle(m_gameNetworkInterface));
-	newGameObstacle->createFromData(messageData);
-	m_gameObstacles.push_back(newGameObstacle);
+	for (unsigned int i = begin; i < end; i++)
+	{
+		float normalX;
+		float normalY;
+
+		float distance = m_obstacleField.distance(unitStates.x[i],
+			unitStates.y[i], normalX, normalY);
+
+		if (distance >= GameUnit::s_radius)
+			continue;
+
+		// Overlapping units are not pushed out, they only bounce off
+		GameUnit gameUnit(&unitStates, i);
+		gameUnit.reflectOn(cv::Vec2f(normalX, normalY));
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const GameUnitPtr Game::unitByID(MessageID messageID) const
+void Game::catchSheep()
 {
-	for (GameUnits::const_iterator i = m_gameUnits.begin();
-		 i != m_gameUnits.end(); i++)
+	m_sheepGrid.clear();
+
+	for (unsigned int i = 0; i < m_unitStates.size(); i++)
 	{
-		if ((*i)->messageID() == messageID)
-			return (*i);
+		uint8_t flags = m_unitStates.flags[i];
+
+		if (!(flags & UnitStates::UNIT_HUNTING) && (flags & UnitStates::UNIT_LIVING))
+			m_sheepGrid.insert(i, m_unitStates.x[i], m_unitStates.y[i]);
 	}
 
-	return GameUnitPtr();
+	forEachUnitTask(boost::bind(&Game::findCaughtSheep, this, _1, _2));
+
+	// Sheep only die after all hunters have looked for them, as in a serial
+	// step where a sheep caught twice simply stays dead
+	unsigned int numberOfTasks = (m_unitStates.size() + s_unitsPerTask - 1)
+		/ s_unitsPerTask;
+
+	for (unsigned int i = 0; i < numberOfTasks; i++)
+	{
+		const std::vector<int> &caughtSheep = m_unitTasks[i].caughtSheep;
+
+		for (unsigned int j = 0; j < caughtSheep.size(); j++)
+			m_unitStates.setFlags(caughtSheep[j],
+				m_unitStates.flags[caughtSheep[j]] & ~UnitStates::UNIT_LIVING);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const GameUnitPtr Game::unitByIndex(PlayerID playerID, uint8_t index) const
+void Game::findCaughtSheep(unsigned int begin, unsigned int end)
 {
-	// Return empty unit if accessing opponent's units
-	if (m_ownPlayerID != ID_NONE && m_ownPlayerID != playerID)
-		return GameUnitPtr();
+	// Hunters catch sheep, units of the same kind don't interact
+	float catchDistance = 2 * GameUnit::s_radius;
 
-	uint8_t currentIndex = 0;
+	UnitTask &unitTask = m_unitTasks[begin / s_unitsPerTask];
+	unitTask.caughtSheep.clear();
 
-	for (GameUnits::const_iterator i = m_gameUnits.begin();
-		 i != m_gameUnits.end(); i++)
+	for (unsigned int i = begin; i < end; i++)
 	{
-		if ((*i)->owner() != playerID)
+		if (!(m_unitStates.flags[i] & UnitStates::UNIT_HUNTING))
 			continue;
 
-		if (currentIndex == index)
-			return *i;
+		m_sheepGrid.within(m_unitStates.x[i], m_unitStates.y[i],
+			catchDistance, unitTask.neighbors);
 
-		currentIndex++;
-	}
+		for (unsigned int j = 0; j < unitTask.neighbors.size(); j++)
+		{
+			int sheep = unitTask.neighbors[j];
 
-	return GameUnitPtr();
+			float dx = m_unitStates.x[i] - m_unitStates.x[sheep];
+			float dy = m_unitStates.y[i] - m_unitStates.y[sheep];
+
+			// within() includes the exact distance, which must be less
+			if (dx * dx + dy * dy < catchDistance * catchDistance)
+				unitTask.caughtSheep.push_back(sheep);
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const GameUnitPtr Game::unitByIndex(uint8_t index) const
+void Game::synchronize(NetworkServerSession *session)
 {
-	return unitByIndex(m_ownPlayerID, index);
+	GameUnitMessage &gameUnitMessage = *m_sentUnitMessage;
+
+	for (unsigned int i = 0; i < m_unitStates.size(); i++)
+	{
+		setUnitMessage(gameUnitMessage, i);
+		gameUnitMessage.synchronize(session);
+	}
+
+	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+		m_gameObstacles[i]->synchronize(session);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const GameObstaclePtr Game::obstacleByID(MessageID messageID) const
+void Game::synchronize(PlayerID playerID)
 {
-	for (GameObstacles::const_iterator i = m_gameObstacles.begin();
-		 i != m_gameObstacles.end(); i++)
+	GameUnitMessage &gameUnitMessage = *m_sentUnitMessage;
+
+	for (unsigned int i = 0; i < m_unitStates.size(); i++)
 	{
-		if ((*i)->messageID() == messageID)
-			return (*i);
+		setUnitMessage(gameUnitMessage, i);
+		gameUnitMessage.synchronize(playerID);
 	}
 
-	return GameObstaclePtr();
+	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+		m_gameObstacles[i]->synchronize(playerID);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::moveUnit(int index, float angle, float strength)
+void Game::setUnitMessage(GameUnitMessage &gameUnitMessage,
+	unsigned int index)
+{
+	gameUnitMessage.setUnit(m_unitStates, index, m_simulationTime);
+
+	PlayerID owner = m_unitStates.owner[index];
+
+	if (owner < m_inputAcknowledgements.size())
+	{
+		const InputAcknowledgement &acknowledgement
+			= m_inputAcknowledgements[owner];
+
+		gameUnitMessage.setInput(acknowledgement.sequence,
+			m_simulationTime - acknowledgement.time);
+	}
+	else
+	{
+		gameUnitMessage.setInput(0, 0.0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::acknowledgeInput(PlayerID playerID, uint16_t inputSequence)
 {
-	MoveRequest moveRequest(m_gameNetworkInterface);
-	moveRequest.setUnitIndex(index);
-	moveRequest.setAngle(angle);
-	moveRequest.setStrength(strength);
-	moveRequest.synchronize(ID_SERVER);
+	if (playerID >= m_inputAcknowledgements.size())
+		m_inputAcknowledgements.resize(playerID + 1);
+
+	// The batch takes effect with the next step
+	InputAcknowledgement &acknowledgement = m_inputAcknowledgements[playerID];
+	acknowledgement.sequence = inputSequence;
+	acknowledgement.time = m_simulationTime;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Game::highlightUnit(int index, bool isHighlighted)
+void Game::start()
+{
+	m_hasStarted = true;
+
+	m_elapsedTime = 0.0;
+}
+
+void Game::stop()
 {
-	HighlightRequest highlightRequest(m_gameNetworkInterface);
-	highlightRequest.setUnitIndex(index);
-	highlightRequest.setHighlighted(isHighlighted);
-	highlightRequest.synchronize(ID_SERVER);
+	m_hasStarted = false;
+	reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::hasStarted() const
+{
+	return m_hasStarted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Game::elapsedTime() const
+{
+	return m_elapsedTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int Game::arrivedUnits() const
+{
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	return m_unitStates.numberOfArrivedSheep();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int Game::survivingUnits() const
+{
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	return m_unitStates.numberOfSurvivingSheep();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Game::lastUnitTime() const
+{
+	return m_lastUnitTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int Game::score() const
+{
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	return 2 * m_unitStates.numberOfArrivedSheep()
+		+ m_unitStates.numberOfSurvivingSheep();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Game::checksum() const
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	for (unsigned int i = 0; i < m_unitStates.size(); i++)
+	{
+		unsigned char bytes[2 * sizeof(float) + 1];
+		memcpy(bytes, &m_unitStates.x[i], sizeof(float));
+		memcpy(bytes + sizeof(float), &m_unitStates.y[i], sizeof(float));
+		bytes[2 * sizeof(float)] = m_unitStates.flags[i];
+
+		for (unsigned int j = 0; j < sizeof(bytes); j++)
+			hash = (hash ^ bytes[j]) * 16777619u;
+	}
+
+	return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::saveState(std::vector<char> &state) const
+{
+	StateHeader header;
+	memset(&header, 0, sizeof(StateHeader));
+	memcpy(header.magic, STATE_MAGIC, sizeof(STATE_MAGIC));
+	header.version = s_stateVersion;
+	header.numberOfUnits = m_unitStates.size();
+	header.numberOfObstacles = m_gameObstacles.size();
+	header.elapsedTime = m_elapsedTime;
+	header.lastUnitTime = m_lastUnitTime;
+	header.hasStarted = m_hasStarted;
+	header.hasFinished = m_hasFinished;
+
+	state.clear();
+	state.reserve(sizeof(StateHeader)
+		+ UnitStates::byteSize(header.numberOfUnits)
+		+ header.numberOfObstacles * sizeof(StateObstacle));
+
+	state.insert(state.end(), (const char *)&header,
+		(const char *)&header + sizeof(StateHeader));
+
+	m_unitStates.appendTo(state);
+
+	for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+	{
+		StateObstacle obstacle;
+		memset(&obstacle, 0, sizeof(StateObstacle));
+		obstacle.messageID = m_gameObstacles[i]->messageID();
+		obstacle.x = m_gameObstacles[i]->x();
+		obstacle.y = m_gameObstacles[i]->y();
+		obstacle.radius = m_gameObstacles[i]->radius();
+
+		state.insert(state.end(), (const char *)&obstacle,
+			(const char *)&obstacle + sizeof(StateObstacle));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::restoreState(const char *state, unsigned int size)
+{
+	// The block need not be aligned, so everything is copied out of it
+	StateHeader header;
+
+	if (size < sizeof(StateHeader))
+		return false;
+
+	memcpy(&header, state, sizeof(StateHeader));
+
+	if (memcmp(header.magic, STATE_MAGIC, sizeof(STATE_MAGIC))
+		|| header.version != s_stateVersion
+		|| size != sizeof(StateHeader)
+			+ (uint64_t)UnitStates::byteSize(header.numberOfUnits)
+			+ (uint64_t)header.numberOfObstacles * sizeof(StateObstacle))
+	{
+		Logging::error("Invalid game state.");
+		return false;
+	}
+
+	const char *units = state + sizeof(StateHeader);
+	const char *obstacles = units + UnitStates::byteSize(header.numberOfUnits);
+
+	bool haveObstaclesChanged
+		= (header.numberOfObstacles != m_gameObstacles.size());
+
+	for (unsigned int i = 0; i < header.numberOfObstacles
+		 && !haveObstaclesChanged; i++)
+	{
+		StateObstacle obstacle;
+		memcpy(&obstacle, obstacles + i * sizeof(StateObstacle),
+			sizeof(StateObstacle));
+
+		haveObstaclesChanged = (obstacle.messageID
+				!= m_gameObstacles[i]->messageID()
+			|| obstacle.x != m_gameObstacles[i]->x()
+			|| obstacle.y != m_gameObstacles[i]->y()
+			|| obstacle.radius != m_gameObstacles[i]->radius());
+	}
+
+	{
+		boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+		m_unitStates.assign(units, header.numberOfUnits);
+		rebuildOwnerTable();
+
+		// Buffered snapshots refer to the units by their former indices
+		m_snapshotBuffer.clear();
+
+		if (haveObstaclesChanged)
+		{
+			m_gameObstacles.clear();
+			m_obstacleIndexByID.clear();
+
+			for (unsigned int i = 0; i < header.numberOfObstacles; i++)
+			{
+				StateObstacle obstacle;
+				memcpy(&obstacle, obstacles + i * sizeof(StateObstacle),
+					sizeof(StateObstacle));
+
+				GameObstaclePtr newGameObstacle(
+					new GameObstacle(m_gameNetworkInterface));
+				newGameObstacle->restoreMessageID(obstacle.messageID);
+				newGameObstacle->setPosition(obstacle.x, obstacle.y);
+				newGameObstacle->setRadius(obstacle.radius);
+				m_gameObstacles.push_back(newGameObstacle);
+
+				m_obstacleIndexByID.insert(obstacle.messageID, i);
+			}
+
+			m_obstacleField.reset(FIELD_SIZE, FIELD_SIZE);
+
+			for (unsigned int i = 0; i < m_gameObstacles.size(); i++)
+				m_obstacleField.addObstacle(m_gameObstacles[i]->x(),
+					m_gameObstacles[i]->y(), m_gameObstacles[i]->radius());
+
+			m_isBackgroundValid = false;
+		}
+	}
+
+	m_elapsedTime = header.elapsedTime;
+	m_lastUnitTime = header.lastUnitTime;
+	m_hasStarted = (header.hasStarted != 0);
+	m_hasFinished = (header.hasFinished != 0);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::hasFinished() const
+{
+	return m_hasFinished;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::handleNewPlayerID(MessageData messageData)
+{
+	NewPlayerID newPlayerID(NULL);
+	newPlayerID.createFromData(messageData);
+
+	std::cout << "[Info] New player ID received." << std::endl;
+
+	m_ownPlayerID = newPlayerID.playerID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::handleGameUnit(MessageData messageData)
+{
+	GameUnitMessage &gameUnitMessage = *m_receivedUnitMessage;
+	gameUnitMessage.createFromData(messageData);
+
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	int index = m_unitStates.indexByID(messageData.messageID());
+	bool isNew = (index < 0);
+
+	if (isNew)
+	{
+		index = m_unitStates.add(messageData.messageID());
+
+		// New units know nothing about requests sent before
+		m_haveUnitsChanged = true;
+	}
+
+	PlayerID previousOwner = m_unitStates.owner[index];
+
+	gameUnitMessage.updateUnit(m_unitStates, index);
+
+	// Units are only ever appended, their owners never change in practice
+	if (isNew)
+		addToOwnerTable(index);
+	else if (m_unitStates.owner[index] != previousOwner)
+		rebuildOwnerTable();
+
+	// All units of a player contain the same input
+	if (m_ownPlayerID != ID_NONE && m_unitStates.owner[index] == m_ownPlayerID)
+	{
+		m_acknowledgedSequence = gameUnitMessage.inputSequence();
+		m_acknowledgedAge = gameUnitMessage.inputAge();
+	}
+
+	m_snapshotBuffer.add(index, gameUnitMessage.time(), m_unitStates.x[index],
+		m_unitStates.y[index], m_unitStates.vx[index], m_unitStates.vy[index]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::handleGameObstacle(MessageData messageData)
+{
+	// The main thread renders the obstacles meanwhile
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	GameObstaclePtr matchingGameObstacle = obstacleByID(messageData.messageID());
+
+	if (matchingGameObstacle)
+		return;
+
+	GameObstaclePtr newGameObstacle(new GameObstacle(m_gameNetworkInterface));
+	newGameObstacle->createFromData(messageData);
+	m_gameObstacles.push_back(newGameObstacle);
+
+	m_obstacleIndexByID.insert(messageData.messageID(),
+		m_gameObstacles.size() - 1);
+
+	// Predicted units bounce off the obstacles as well
+	m_obstacleField.addObstacle(newGameObstacle->x(), newGameObstacle->y(),
+		newGameObstacle->radius());
+
+	m_isBackgroundValid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const GameUnitPtr Game::unitByID(MessageID messageID) const
+{
+	int index = m_unitStates.indexByID(messageID);
+
+	if (index < 0)
+		return GameUnitPtr();
+
+	return GameUnitPtr(new GameUnit(unitStates(), index));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const GameUnitPtr Game::unitByIndex(PlayerID playerID, uint8_t index) const
+{
+	// Return empty unit if accessing opponent's units
+	if (m_ownPlayerID != ID_NONE && m_ownPlayerID != playerID)
+		return GameUnitPtr();
+
+	if (playerID >= m_unitsByOwner.size()
+		|| index >= m_unitsByOwner[playerID].size())
+		return GameUnitPtr();
+
+	return GameUnitPtr(new GameUnit(unitStates(),
+		m_unitsByOwner[playerID][index]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const GameUnitPtr Game::unitByIndex(uint8_t index) const
+{
+	return unitByIndex(m_ownPlayerID, index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::applyMove(PlayerID playerID, uint8_t index, float angle,
+	float strength)
+{
+	if (playerID >= m_unitsByOwner.size()
+		|| index >= m_unitsByOwner[playerID].size())
+		return false;
+
+	GameUnit(&m_unitStates, m_unitsByOwner[playerID][index]).setAcceleration(
+		GameUnit::moveAcceleration(angle, strength));
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::applyHighlight(PlayerID playerID, uint8_t index,
+	bool isHighlighted)
+{
+	if (playerID >= m_unitsByOwner.size()
+		|| index >= m_unitsByOwner[playerID].size())
+		return false;
+
+	GameUnit(&m_unitStates, m_unitsByOwner[playerID][index]).setHighlighted(
+		isHighlighted);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const UnitStates &Game::ownUnitStates() const
+{
+	return m_predictedStates;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+UnitStates *Game::unitStates() const
+{
+	// Units handed out may be modified (e. g. by the server's requests)
+	return const_cast<UnitStates*>(&m_unitStates);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const GameObstaclePtr Game::obstacleByID(MessageID messageID) const
+{
+	int index = m_obstacleIndexByID.find(messageID);
+
+	if (index < 0)
+		return GameObstaclePtr();
+
+	return m_gameObstacles[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::addToOwnerTable(unsigned int index)
+{
+	PlayerID owner = m_unitStates.owner[index];
+
+	if (owner >= m_unitsByOwner.size())
+		m_unitsByOwner.resize(owner + 1);
+
+	// Appended units have the highest index, which keeps the order
+	m_unitsByOwner[owner].push_back(index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::rebuildOwnerTable()
+{
+	m_unitsByOwner.clear();
+
+	for (unsigned int i = 0; i < m_unitStates.size(); i++)
+		addToOwnerTable(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Game::UnitInput::UnitInput()
+{
+	hasMove = false;
+	angle = 0.0f;
+	strength = 0.0f;
+
+	hasHighlight = false;
+	isHighlighted = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Game::InputAcknowledgement::InputAcknowledgement()
+{
+	sequence = 0;
+	time = 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Game::UnitInput &Game::requestedInput(int index)
+{
+	if ((unsigned int)index >= m_requestedInput.size())
+		m_requestedInput.resize(index + 1);
+
+	return m_requestedInput[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Game::isSameMove(const UnitInput &first, const UnitInput &second)
+{
+	if (fabs(first.strength - second.strength) > INPUT_STRENGTH_TOLERANCE)
+		return false;
+
+	// Without strength, the direction doesn't matter
+	if (first.strength == 0.0f && second.strength == 0.0f)
+		return true;
+
+	float angleDifference = fmod(fabs(first.angle - second.angle),
+		2.0f * (float)CV_PI);
+
+	if (angleDifference > (float)CV_PI)
+		angleDifference = 2.0f * (float)CV_PI - angleDifference;
+
+	return angleDifference <= INPUT_ANGLE_TOLERANCE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::moveUnit(int index, float angle, float strength)
+{
+	if (index < 0 || index > MAXIMAL_UNIT_INDEX)
+	{
+		Logging::error("Invalid unit index to move.");
+		return;
+	}
+
+	UnitInput &input = requestedInput(index);
+	input.hasMove = true;
+	input.angle = angle;
+	input.strength = strength;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::highlightUnit(int index, bool isHighlighted)
+{
+	if (index < 0 || index > MAXIMAL_UNIT_INDEX)
+	{
+		Logging::error("Invalid unit index to highlight.");
+		return;
+	}
+
+	UnitInput &input = requestedInput(index);
+	input.hasHighlight = true;
+	input.isHighlighted = isHighlighted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::sendInput()
+{
+	// Send everything again after the server replaced the units
+	if (m_haveUnitsChanged.exchange(false))
+		m_sentInput.clear();
+
+	m_sentInput.resize(m_requestedInput.size());
+
+	InputBatch &inputBatch = *m_inputBatch;
+	inputBatch.clear();
+
+	// All batches of a frame share one sequence number, 0 means unnumbered
+	uint16_t inputSequence = m_inputSequence + 1;
+
+	if (inputSequence == 0)
+		inputSequence = 1;
+
+	inputBatch.setSequenceNumber(inputSequence);
+
+	for (unsigned int i = 0; i < m_requestedInput.size(); i++)
+	{
+		const UnitInput &requested = m_requestedInput[i];
+		UnitInput &sent = m_sentInput[i];
+
+		InputBatch::Command command;
+		command.unitIndex = (uint8_t)i;
+		command.flags = 0;
+		command.angle = requested.angle;
+		command.strength = requested.strength;
+
+		if (requested.hasMove
+			&& (!sent.hasMove || !isSameMove(requested, sent)))
+		{
+			command.flags |= InputBatch::COMMAND_MOVE;
+
+			sent.hasMove = true;
+			sent.angle = requested.angle;
+			sent.strength = requested.strength;
+		}
+
+		if (requested.hasHighlight
+			&& (!sent.hasHighlight || sent.isHighlighted != requested.isHighlighted))
+		{
+			command.flags |= InputBatch::COMMAND_HIGHLIGHT;
+
+			if (requested.isHighlighted)
+				command.flags |= InputBatch::COMMAND_HIGHLIGHTED;
+
+			sent.hasHighlight = true;
+			sent.isHighlighted = requested.isHighlighted;
+		}
+
+		if (!command.flags)
+			continue;
+
+		if (inputBatch.isFull())
+		{
+			inputBatch.synchronize(ID_SERVER);
+			inputBatch.clear();
+		}
+
+		inputBatch.addCommand(command);
+	}
+
+	if (inputBatch.isEmpty())
+		return;
+
+	inputBatch.synchronize(ID_SERVER);
+
+	m_inputSequence = inputSequence;
+
+	SentInput sentInput;
+	sentInput.sequence = inputSequence;
+	sentInput.time = Clock::seconds();
+
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	m_sentInputs.push_back(sentInput);
+
+	if (m_sentInputs.size() > MAXIMAL_SENT_INPUTS)
+		m_sentInputs.pop_front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::predict()
+{
+	double now = Clock::seconds();
+
+	boost::lock_guard<boost::mutex> lock(m_unitStatesMutex);
+
+	// Start from the latest server state of the own units
+	m_predictedStates.clear();
+
+	static const std::vector<unsigned int> noUnits;
+
+	const std::vector<unsigned int> &ownUnits = (m_ownPlayerID != ID_NONE
+		&& m_ownPlayerID < m_unitsByOwner.size())
+		? m_unitsByOwner[m_ownPlayerID] : noUnits;
+
+	for (unsigned int j = 0; j < ownUnits.size(); j++)
+	{
+		unsigned int i = ownUnits[j];
+		unsigned int index = m_predictedStates.add(m_unitStates.messageID[i]);
+
+		m_predictedStates.x[index] = m_unitStates.x[i];
+		m_predictedStates.y[index] = m_unitStates.y[i];
+		m_predictedStates.vx[index] = m_unitStates.vx[i];
+		m_predictedStates.vy[index] = m_unitStates.vy[i];
+		m_predictedStates.setFlags(index, m_unitStates.flags[i]);
+		m_predictedStates.number[index] = m_unitStates.number[i];
+		m_predictedStates.owner[index] = m_unitStates.owner[i];
+	}
+
+	// The input sent this frame applies from now on, as it does on the
+	// server once the batch arrives
+	PredictedFrame predictedFrame;
+	predictedFrame.time = now;
+	predictedFrame.accelerations.resize(m_predictedStates.size(),
+		cv::Vec2f(0.0f, 0.0f));
+
+	for (unsigned int i = 0; i < predictedFrame.accelerations.size()
+		 && i < m_sentInput.size(); i++)
+	{
+		if (m_sentInput[i].hasMove)
+			predictedFrame.accelerations[i] = GameUnit::moveAcceleration(
+				m_sentInput[i].angle, m_sentInput[i].strength);
+	}
+
+	m_predictedFrames.push_back(predictedFrame);
+
+	// Keep the frame which was current s_maximalPrediction seconds ago
+	while (m_predictedFrames.size() > 1
+		   && m_predictedFrames[1].time <= now - s_maximalPrediction)
+		m_predictedFrames.pop_front();
+
+	double begin = now - predictionHorizon(now);
+
+	for (unsigned int i = 0; i < m_predictedFrames.size(); i++)
+	{
+		double end = (i + 1 < m_predictedFrames.size())
+			? m_predictedFrames[i + 1].time : now;
+
+		if (end <= begin)
+			continue;
+
+		replay(m_predictedFrames[i], (float)(end - begin));
+
+		begin = end;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Game::predictionHorizon(double now)
+{
+	// The server state contains the acknowledged batch plus the time
+	// simulated since; everything the player did afterwards is missing
+	for (unsigned int i = m_sentInputs.size(); i-- > 0;)
+	{
+		if (m_sentInputs[i].sequence != m_acknowledgedSequence)
+			continue;
+
+		m_predictionHorizon = now - m_sentInputs[i].time - m_acknowledgedAge;
+		break;
+	}
+
+	// Without a recent batch, the round-trip time is still about the same
+	return std::min(std::max(m_predictionHorizon, 0.0),
+		(double)s_maximalPrediction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Game::replay(const PredictedFrame &predictedFrame, float duration)
+{
+	unsigned int numberOfUnits = std::min(m_predictedStates.size(),
+		(unsigned int)predictedFrame.accelerations.size());
+
+	for (unsigned int i = 0; i < numberOfUnits; i++)
+	{
+		m_predictedStates.ax[i] = predictedFrame.accelerations[i][0];
+		m_predictedStates.ay[i] = predictedFrame.accelerations[i][1];
+	}
+
+	while (duration > 0.0f)
+	{
+		float step = std::min(duration, MAXIMAL_PREDICTION_STEP);
+
+		m_predictedStates.move(step, GameUnit::s_maximalVelocity,
+			GameUnit::s_brakeFactor);
+		m_predictedStates.reflectOnWalls(GameUnit::s_radius / 2,
+			480 - GameUnit::s_radius / 2);
+		collideWithObstacles(m_predictedStates, 0, m_predictedStates.size());
+
+		duration -= step;
+	}
 }
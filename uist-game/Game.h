@@ -1,23 +1,153 @@
 #ifndef __GAME_GAME_H
 #define __GAME_GAME_H
 
-#include <boost/timer.hpp>
+#include <deque>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "MessageData.h"
+#include "UnitStates.h"
+#include "UnitSprites.h"
+#include "MessageIDMap.h"
+#include "SpatialGrid.h"
+#include "ObstacleField.h"
+#include "SnapshotBuffer.h"
+#include "TaskScheduler.h"
 #include "ForwardDeclarations.h"
 
 class Game
 {
 	public:
+		/** @brief Units per task when a step is split across threads. */
+		static unsigned int s_unitsPerTask;
+
+		/** @brief Longest time in seconds own units are predicted ahead of
+		 * the server. */
+		static float s_maximalPrediction;
+
+		/** @brief Highest index moveUnit and highlightUnit accept, as unit
+		 * indices are transmitted as uint8_t. */
+		static const int MAXIMAL_UNIT_INDEX = 255;
+
+	public:
+		/**
+		 * @brief Creates an empty game.
+		 *
+		 * @param gameNetworkInterface - The network interface to synchronize
+		 *     the game with, or NULL for a game which is only simulated (e. g.
+		 *     in benchmarks).
+		 */
 		Game(GameNetworkInterface *gameNetworkInterface);
 
 		void load(int levelNumber);
 
+		/**
+		 * @brief Adds a unit to the loaded level.
+		 *
+		 * @return Index of the new unit.
+		 */
+		unsigned int addUnit(PlayerID owner, uint8_t number, float x, float y,
+			bool isHunting);
+
+		unsigned int numberOfUnits() const;
+
+		/**
+		 * @brief Draws the game.
+		 *
+		 * Units received from the server are drawn slightly in the past,
+		 * interpolated between their snapshots (see SnapshotBuffer). The
+		 * background and the obstacles, which do not move, are only drawn
+		 * once per level and then copied.
+		 *
+		 * If the image is the same as in the last call and has not been
+		 * drawn on meanwhile, only the tiles around units which moved or
+		 * changed are drawn again (see dirtyRects).
+		 */
 		void render(cv::Mat &image);
 
-		void proceed();
+		/** @brief Returns the regions of the image the last render changed. */
+		const std::vector<cv::Rect> &dirtyRects() const;
+
+		/**
+		 * @brief Lets the simulation steps run on several threads.
+		 *
+		 * The result of a step does not depend on the number of threads.
+		 *
+		 * @param taskScheduler - Scheduler shared with other games, or NULL to
+		 *     simulate on the calling thread only.
+		 */
+		void setTaskScheduler(TaskScheduler *taskScheduler);
+
+		/**
+		 * @brief Advances the simulation by one step.
+		 *
+		 * @param timeDifference - Simulated time of the step in seconds.
+		 */
+		void proceed(float timeDifference);
+
+		/** @brief Returns the simulated time since the game started. */
+		double elapsedTime() const;
+
+		/**
+		 * @brief Returns the number of living sheep behind the goal line.
+		 *
+		 * Like survivingUnits and score, this is counted along as the units
+		 * change and can be queried each frame, e. g. on the client while
+		 * units are being received.
+		 */
+		int arrivedUnits() const;
+
+		/** @brief Returns the number of living sheep before the goal line. */
+		int survivingUnits() const;
+
+		/**
+		 * @brief Returns the elapsed time when the last sheep arrived, or a
+		 * negative value if none has arrived yet.
+		 */
+		double lastUnitTime() const;
+
+		/** @brief Returns the sheep player's score: 2 points per arrived
+		 * sheep and 1 point per surviving one. */
+		int score() const;
+
+		/**
+		 * @brief Returns a hash of the positions and flags of all units.
+		 *
+		 * Simulating the same input again gives the same hash (see
+		 * MatchJournal).
+		 */
+		uint32_t checksum() const;
+
+		/**
+		 * @brief Copies the complete simulation state into one block of
+		 * memory.
+		 *
+		 * The block holds the units, the obstacles, the elapsed and last
+		 * arrival time and whether the game has started or finished. It can
+		 * be stored or sent as is, e. g. to bring a late-joining client up to
+		 * date or to branch a simulated match. Neither the client's
+		 * prediction nor input state are included.
+		 *
+		 * @param state - Receives the block, reusing its memory.
+		 */
+		void saveState(std::vector<char> &state) const;
+
+		/**
+		 * @brief Continues the game from a block written by saveState.
+		 *
+		 * Takes time linear in the size of the block. The obstacle field is
+		 * only baked again if the obstacles differ from the current ones.
+		 * The simulation time sent with the units keeps running, so clients
+		 * never see it go backwards.
+		 *
+		 * @return false if the block is no game state of this version, which
+		 *     leaves the game unchanged.
+		 */
+		bool restoreState(const char *state, unsigned int size);
 
 		void synchronize(NetworkServerSession *session);
 		void synchronize(PlayerID playerID);
@@ -32,12 +162,200 @@ class Game
 
 		const GameUnitPtr unitByIndex(uint8_t index) const;
 
+		/**
+		 * @brief Accelerates a unit as requested by its owner.
+		 *
+		 * Unlike going through unitByIndex, no unit object is allocated, which
+		 * keeps the server's input path free of heap allocations.
+		 *
+		 * @param playerID - The owner of the unit.
+		 * @param index - The unit's index among the owner's units.
+		 *
+		 * @return False if the player has no unit with this index.
+		 */
+		bool applyMove(PlayerID playerID, uint8_t index, float angle,
+			float strength);
+
+		/** @brief (Un)highlights a unit as requested by its owner, see
+		 * applyMove. */
+		bool applyHighlight(PlayerID playerID, uint8_t index,
+			bool isHighlighted);
+
+		/**
+		 * @brief Returns the units of this client's player.
+		 *
+		 * The units are the predicted ones from the last predict() call, as
+		 * the player sees them, ordered by their index as used by moveUnit
+		 * and highlightUnit. Only the first MAXIMAL_UNIT_INDEX + 1 of them can
+		 * be controlled. Read them directly instead of creating GameUnits, so
+		 * that handling the input of a frame does not allocate.
+		 */
+		const UnitStates &ownUnitStates() const;
+
 		const GameObstaclePtr obstacleByID(MessageID messageID) const;
 
+		/**
+		 * @brief Requests moving one of the own units.
+		 *
+		 * The request is only sent with the next sendInput() call, and only if
+		 * it differs noticeably from what has been sent for this unit before.
+		 */
 		void moveUnit(int index, float angle, float strength);
+
+		/**
+		 * @brief Requests (un)highlighting one of the own units.
+		 *
+		 * The request is only sent with the next sendInput() call, and only if
+		 * the unit's highlight state changes.
+		 */
 		void highlightUnit(int index, bool isHighlighted = true);
 
+		/**
+		 * @brief Sends the changed unit requests as one batch.
+		 *
+		 * Call once per frame.
+		 */
+		void sendInput();
+
+		/**
+		 * @brief Predicts the own units from the input the server has not
+		 * simulated yet.
+		 *
+		 * Starts from the latest state received from the server and replays
+		 * the input sent since the batch that state contains. Call once per
+		 * frame after sendInput(), so that input shows up immediately.
+		 */
+		void predict();
+
+		/**
+		 * @brief Notes that an input batch of a player has been applied.
+		 *
+		 * The units sent afterwards tell the player how long ago that was.
+		 *
+		 * @param playerID - The player who sent the batch.
+		 * @param inputSequence - Sequence number of the batch.
+		 */
+		void acknowledgeInput(PlayerID playerID, uint16_t inputSequence);
+
 	protected:
+		/**
+		 * @struct UnitInput
+		 *
+		 * @brief Requested or last sent input state of one own unit.
+		 */
+		struct UnitInput
+		{
+			UnitInput();
+
+			bool hasMove;
+			float angle;
+			float strength;
+
+			bool hasHighlight;
+			bool isHighlighted;
+		};
+
+		typedef std::vector<UnitInput> UnitInputs;
+
+		/**
+		 * @struct InputAcknowledgement
+		 *
+		 * @brief Last input batch of a player applied by the server.
+		 */
+		struct InputAcknowledgement
+		{
+			InputAcknowledgement();
+
+			uint16_t sequence;
+
+			/** @brief Simulation time when the batch was applied. */
+			double time;
+		};
+
+		/**
+		 * @struct SentInput
+		 *
+		 * @brief Sequence number and local time of a sent input batch.
+		 */
+		struct SentInput
+		{
+			uint16_t sequence;
+			double time;
+		};
+
+		/**
+		 * @struct PredictedFrame
+		 *
+		 * @brief Accelerations of the own units from one frame on.
+		 */
+		struct PredictedFrame
+		{
+			/** @brief Local time the accelerations apply from. */
+			double time;
+
+			/** @brief Per own unit index. */
+			std::vector<cv::Vec2f> accelerations;
+		};
+
+		/**
+		 * @struct UnitTask
+		 *
+		 * @brief Results of one range of units within a step.
+		 *
+		 * The results are applied in the order of the ranges after all of
+		 * them are done, which keeps the step deterministic.
+		 */
+		struct UnitTask
+		{
+			std::vector<int> arrivedUnits;
+
+			std::vector<int> neighbors;
+			std::vector<int> caughtSheep;
+		};
+
+		typedef std::vector<UnitTask> UnitTasks;
+
+		/**
+		 * @struct StateHeader
+		 *
+		 * @brief Start of a block written by saveState.
+		 *
+		 * Followed by the unit arrays (see UnitStates::appendTo) and one
+		 * StateObstacle per obstacle.
+		 */
+		struct StateHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t numberOfUnits;
+			uint32_t numberOfObstacles;
+
+			double elapsedTime;
+			double lastUnitTime;
+
+			uint8_t hasStarted;
+			uint8_t hasFinished;
+			uint8_t reserved[6];
+		};
+
+		struct StateObstacle
+		{
+			MessageID messageID;
+			uint16_t reserved;
+
+			float x;
+			float y;
+			float radius;
+		};
+
+		static const uint32_t s_stateVersion = 1;
+
+		static bool isSameMove(const UnitInput &first, const UnitInput &second);
+
+		UnitInput &requestedInput(int index);
+
+		UnitStates *unitStates() const;
+
 		void initializeMessageHandlers();
 
 		void handleNewPlayerID(MessageData messageData);
@@ -45,22 +363,170 @@ class Game
 		void handleGameUnit(MessageData messageData);
 		void handleGameObstacle(MessageData messageData);
 
+		/** @brief Loads a unit for sending, with its owner's input state. */
+		void setUnitMessage(GameUnitMessage &gameUnitMessage,
+			unsigned int index);
+
+		/**
+		 * @brief Returns how far the own units need to be predicted ahead of
+		 * the latest server state.
+		 *
+		 * @param now - Local time in seconds.
+		 */
+		double predictionHorizon(double now);
+
+		/** @brief Appends a unit to the table of its owner's units. */
+		void addToOwnerTable(unsigned int index);
+		void rebuildOwnerTable();
+
+		/** @brief Simulates the predicted units with one frame's input. */
+		void replay(const PredictedFrame &predictedFrame, float duration);
+
 		void reset();
 
+
+		/** @brief Calls function for each task's range of units. */
+		void forEachUnitTask(const TaskScheduler::RangeFunction &function);
+
+		void proceedUnits(float timeDifference, unsigned int begin,
+			unsigned int end);
+		void collideWithObstacles(UnitStates &unitStates, unsigned int begin,
+			unsigned int end);
+
+		void catchSheep();
+		void findCaughtSheep(unsigned int begin, unsigned int end);
+
+		/** @brief Draws the static layer of the level into m_background. */
+		void renderBackground(cv::Size size, int type);
+
+		/** @brief Draws the tiles changed since the last frame. */
+		void renderDirtyTiles(cv::Mat &image);
+		void markDirtyTiles(const cv::Rect &rect, int columns, int rows);
+
+		/** @brief Finds the tiles a rect overlaps, false if there are none. */
+		static bool tileRange(const cv::Rect &rect, int columns, int rows,
+			int &firstColumn, int &firstRow, int &lastColumn, int &lastRow);
+
 		bool m_hasStarted;
 		bool m_hasFinished;
 
-		boost::timer m_timer;
-		boost::timer m_durationTimer;
+		/** @brief Simulated seconds since the game started. */
+		double m_elapsedTime;
 
 		double m_lastUnitTime;
 
-		GameUnits m_gameUnits;
+		/** @brief Simulated seconds since the game was created, sent along
+		 * with the units. */
+		double m_simulationTime;
+
+		/** @brief All units, also those of other players. */
+		UnitStates m_unitStates;
+
+		/** @brief Guards the units and the obstacles against the network
+		 * thread (client). */
+		mutable boost::mutex m_unitStatesMutex;
+
+		/** @brief Received unit states, for interpolation (client). */
+		SnapshotBuffer m_snapshotBuffer;
+
+		/** @brief The units as drawn, reused each frame. */
+		UnitStates m_renderStates;
+
+		/** @brief Background and obstacles, copied into each frame. */
+		cv::Mat m_background;
+
+		/** @brief The looks of the units, blended into each frame. */
+		UnitSprites m_unitSprites;
+
+		/** @brief Where a unit was drawn in the last frame, and how. */
+		struct RenderedUnit
+		{
+			cv::Rect bounds;
+			unsigned int sprite;
+		};
+
+		std::vector<RenderedUnit> m_renderedUnits;
+
+		/** @brief Pixels of the image drawn in the last frame. */
+		const uint8_t *m_renderTarget;
+
+		/** @brief Tiles to draw in this frame, row by row. */
+		std::vector<bool> m_dirtyTiles;
+
+		std::vector<cv::Rect> m_dirtyRects;
+
+		/** @brief Cleared whenever the obstacles change, also by the
+		 * network thread (client). */
+		boost::atomic<bool> m_isBackgroundValid;
+
+		/** @brief Last applied input batch per player ID (server). */
+		std::vector<InputAcknowledgement> m_inputAcknowledgements;
+
+		/** @brief The own units, predicted ahead of the server (client). */
+		UnitStates m_predictedStates;
+
+		/** @brief Input of the last s_maximalPrediction seconds. */
+		std::deque<PredictedFrame> m_predictedFrames;
+
+		/** @brief Recently sent input batches. */
+		std::deque<SentInput> m_sentInputs;
+
+		/** @brief Sequence number of the last sent input batch. */
+		uint16_t m_inputSequence;
+
+		/** @brief Refilled for each batch instead of creating a message per
+		 * frame (client). */
+		InputBatchPtr m_inputBatch;
+
+		/** @brief Refilled for each sent unit, as registering the message
+		 * type per tick would allocate (server). */
+		GameUnitMessagePtr m_sentUnitMessage;
+
+		/** @brief Decodes each received unit, only used by the network
+		 * thread (client). */
+		GameUnitMessagePtr m_receivedUnitMessage;
+
+		/** @brief Own input batch the latest received units contain. */
+		uint16_t m_acknowledgedSequence;
+
+		/** @brief Seconds the server had simulated since applying it. */
+		double m_acknowledgedAge;
+
+		/** @brief Last known prediction horizon in seconds. */
+		double m_predictionHorizon;
+
+		/** @brief Living sheep, rebuilt each step for the hunters to query. */
+		SpatialGrid m_sheepGrid;
+
+		/** @brief Distance to the obstacles, baked once per level. */
+		ObstacleField m_obstacleField;
+
+		/** @brief Indices of each player's units, by player ID. Position i
+		 * is the unit moveUnit and highlightUnit call index i. */
+		std::vector<std::vector<unsigned int> > m_unitsByOwner;
+
+		TaskScheduler *m_taskScheduler;
+		UnitTasks m_unitTasks;
+
+		/** @brief Added by the network thread (client), so only changed
+		 * while holding m_unitStatesMutex. */
 		GameObstacles m_gameObstacles;
 
+		/** @brief Index into m_gameObstacles by message ID. */
+		MessageIDMap m_obstacleIndexByID;
+
 		GameNetworkInterface *m_gameNetworkInterface;
 
 		PlayerID m_ownPlayerID;
+
+		/** @brief Latest requested input per unit index. */
+		UnitInputs m_requestedInput;
+
+		/** @brief Input per unit index the server already knows about. */
+		UnitInputs m_sentInput;
+
+		/** @brief Set by the network thread when the units were replaced. */
+		boost::atomic<bool> m_haveUnitsChanged;
 };
 
 #endif
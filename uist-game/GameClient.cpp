@@ -6,8 +6,13 @@
 
 #include "Game.h"
 #include "GameNetworkClient.h"
+#include "Ping.h"
+#include "Clock.h"
 #include "Logging.h"
 
+// Interval between two round-trip time measurements in microseconds
+const uint64_t PING_INTERVAL = 500000;
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // GameClient
@@ -16,6 +21,10 @@
 
 GameClient::GameClient()
 {
+	m_pingSequenceNumber = 0;
+	m_lastPingTime = 0;
+	m_roundTripTime = -1.0;
+
 	// Initialize the game network client
 	m_gameNetworkClient = new GameNetworkClient;
 
@@ -23,6 +32,12 @@ GameClient::GameClient()
 	m_gameNetworkClient->onConnectionClosed.connect(
 		boost::bind(&GameClient::handleConnectionClosed, this));
 
+	// Measure the round-trip time with the echoed pings
+	m_gameNetworkClient->addMessageHandler(
+		MESSAGE_PING,
+		MESSAGE_ID_EVENT,
+		boost::bind(&GameClient::handlePing, this, _1));
+
 	m_game = GamePtr(new Game(m_gameNetworkClient));
 }
 
@@ -85,7 +100,52 @@ void GameClient::cleanUpLeftGame()
 
 void GameClient::sendRequests()
 {
+	if (!m_gameNetworkClient || !m_gameNetworkClient->isConnected())
+		return;
+
+	if (m_game)
+	{
+		m_game->sendInput();
+		m_game->predict();
+	}
+
+	uint64_t now = Clock::microseconds();
+
+	if (now - m_lastPingTime < PING_INTERVAL)
+		return;
+
+	m_lastPingTime = now;
+
+	Ping ping(m_gameNetworkClient);
+	ping.setSequenceNumber(m_pingSequenceNumber++);
+	ping.setSendTime(now);
+	ping.synchronize(ID_SERVER);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameClient::handlePing(MessageData messageData)
+{
+	Ping ping(NULL);
+	ping.createFromData(messageData);
+
+	double roundTripTime = (Clock::microseconds() - ping.sendTime()) / 1000.0;
+
+	// Smooth out single outliers; only this thread writes the value
+	double smoothedRoundTripTime = m_roundTripTime.load();
 
+	if (smoothedRoundTripTime < 0)
+		m_roundTripTime.store(roundTripTime);
+	else
+		m_roundTripTime.store(0.8 * smoothedRoundTripTime
+			+ 0.2 * roundTripTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameClient::roundTripTime() const
+{
+	return m_roundTripTime.load();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2,6 +2,7 @@
 #define __GAME_GAMECLIENT_H
 
 #include <boost/asio.hpp>
+#include <boost/atomic.hpp>
 #include <boost/signal.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -52,6 +53,22 @@ class GameClient
 		 */
 		void signOut();
 
+		/**
+		 * @brief Sends pending requests to the server.
+		 *
+		 * Call once per frame. Sends the unit requests of this frame as one
+		 * batch, and a ping every now and then to measure the round-trip time.
+		 */
+		void sendRequests();
+
+		/**
+		 * @brief Returns the smoothed network round-trip time.
+		 *
+		 * @return Round-trip time to the server in milliseconds, or -1 if not
+		 *     measured yet.
+		 */
+		double roundTripTime() const;
+
 		GamePtr game();
 
 		/** @brief Signal emitted if stopping the application is requested. **/
@@ -59,14 +76,23 @@ class GameClient
 
 	protected:
 		void handleConnectionClosed();
+		void handlePing(MessageData messageData);
 
 		void cleanUpLeftGame();
 
-		void sendRequests();
-
 		GamePtr m_game;
 
 		GameNetworkClient *m_gameNetworkClient;
+
+		uint32_t m_pingSequenceNumber;
+		uint64_t m_lastPingTime;
+
+		/**
+		 * @brief Smoothed round-trip time in milliseconds (-1: unknown).
+		 *
+		 * Written by the network thread, read by the HUD.
+		 */
+		boost::atomic<double> m_roundTripTime;
 };
 
 #endif
@@ -76,3 +76,10 @@ float GameObstacle::radius() const
 {
 	return m_gameObstacleData.radius;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameObstacle::restoreMessageID(MessageID messageID)
+{
+	setMessageID(messageID);
+}
@@ -24,6 +24,10 @@ class GameObstacle : public Message
 		void setRadius(float radius);
 		float radius() const;
 
+		/** @brief Gives a restored obstacle the ID it was synchronized with
+		 * before (see Game::restoreState). */
+		void restoreMessageID(MessageID messageID);
+
 	protected:
 		void debug();
 
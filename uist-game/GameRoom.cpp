@@ -0,0 +1,387 @@
+#include "GameRoom.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "Game.h"
+#include "NewPlayerID.h"
+#include "NetworkServerSession.h"
+#include "PlayerProfile.h"
+#include "Clock.h"
+#include "Logging.h"
+#include "Profiling.h"
+
+unsigned int GameRoom::s_maximalPlayers = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// GameRoom
+//
+////////////////////////////////////////////////////////////////////////////////
+
+GameRoom::GameRoom(boost::asio::io_service &ioService, double tickInterval,
+	TaskScheduler *taskScheduler)
+	: m_tickTimer(ioService),
+	  m_timestep(tickInterval)
+{
+	m_taskScheduler = taskScheduler;
+
+	m_isRunning = false;
+	m_isTicking = false;
+
+	m_lastTickTime = 0;
+	m_tickJitter = 0;
+	m_simulationCost = 0;
+
+	m_numberOfSteps = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GameRoom::~GameRoom()
+{
+	stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::run()
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	m_isRunning = true;
+
+	if (!m_players.empty() && !m_isTicking)
+		scheduleTick();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::stop()
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	m_isRunning = false;
+	m_tickTimer.cancel();
+
+	finishJournal();
+
+	if (m_game)
+		m_game->stop();
+
+	removeAllMessageHandlers();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::loadGame(int levelNumber)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	finishJournal();
+
+	m_game = GamePtr(new Game(this));
+	m_game->setTaskScheduler(m_taskScheduler);
+	m_game->load(levelNumber);
+
+	m_numberOfSteps = 0;
+
+	if (m_journalPrefix.empty())
+		return;
+
+	std::string time = boost::posix_time::to_iso_string(
+		boost::posix_time::microsec_clock::local_time());
+	std::string fileName = m_journalPrefix + "-" + time + ".journal";
+
+	if (m_matchJournal.create(fileName, levelNumber,
+			(float)m_timestep.stepLength()))
+		Logging::info("Recording the match to " + fileName + ".");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::finishJournal()
+{
+	if (!m_matchJournal.isRecording())
+		return;
+
+	m_matchJournal.close(m_numberOfSteps);
+
+	// A replay of the journal has to end with the same checksum
+	std::stringstream info;
+	info << "Recorded " << m_numberOfSteps << " steps, checksum " << std::hex
+		 << (m_game ? m_game->checksum() : 0) << ".";
+	Logging::info(info.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::startGame()
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	if (!m_game)
+		return;
+
+	m_game->start();
+	m_matchJournal.recordStart(m_numberOfSteps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::recordMatches(const std::string &fileNamePrefix)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	m_journalPrefix = fileNamePrefix;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool GameRoom::addPlayer(NetworkServerSession *session)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	if (m_players.size() >= s_maximalPlayers)
+		return false;
+
+	// Take the lowest free player ID, a rejoining player gets the units back
+	PlayerID playerID = ID_FIRST_CLIENT;
+
+	while (playerProfileByID(playerID))
+		playerID++;
+
+	PlayerProfilePtr newProfile(new PlayerProfile);
+	newProfile->setPlayerID(playerID);
+	newProfile->setSession(session);
+	m_players.push_back(newProfile);
+
+	NewPlayerID newPlayerID(this);
+	newPlayerID.setPlayerID(playerID);
+	newPlayerID.synchronize(session);
+
+	if (m_game)
+		m_game->synchronize(session);
+
+	if (m_isRunning && !m_isTicking)
+		scheduleTick();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::removePlayer(NetworkServerSession *session)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	for (PlayerProfiles::iterator i = m_players.begin(); i != m_players.end();
+		 i++)
+	{
+		if ((*i)->session() == session)
+		{
+			m_players.erase(i);
+			break;
+		}
+	}
+
+	// The next tick notices that the room is empty and stops ticking
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int GameRoom::numberOfPlayers()
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	return m_players.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::moveUnit(NetworkServerSession *session, uint8_t unitIndex,
+	float angle, float strength)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	PlayerProfilePtr playerProfile = playerProfileBySession(session);
+
+	if (!m_game || !playerProfile || !m_game->applyMove(
+			playerProfile->playerID(), unitIndex, angle, strength))
+	{
+		Logging::error("Game unit requested to move does not exist.");
+		return;
+	}
+
+	m_matchJournal.recordMove(m_numberOfSteps, playerProfile->playerID(),
+		unitIndex, angle, strength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::acknowledgeInput(NetworkServerSession *session,
+	uint16_t inputSequence)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	PlayerProfilePtr playerProfile = playerProfileBySession(session);
+
+	if (m_game && playerProfile)
+		m_game->acknowledgeInput(playerProfile->playerID(), inputSequence);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::highlightUnit(NetworkServerSession *session, uint8_t unitIndex,
+	bool isHighlighted)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	PlayerProfilePtr playerProfile = playerProfileBySession(session);
+
+	if (!m_game || !playerProfile || !m_game->applyHighlight(
+			playerProfile->playerID(), unitIndex, isHighlighted))
+	{
+		Logging::error("Game unit requested to be highlighted does not exist.");
+		return;
+	}
+
+	m_matchJournal.recordHighlight(m_numberOfSteps, playerProfile->playerID(),
+		unitIndex, isHighlighted);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::send(MessageData messageData, PlayerID receiverID)
+{
+	for (PlayerProfiles::iterator i = m_players.begin(); i != m_players.end();
+		 i++)
+	{
+		if (receiverID == ID_ALL_CLIENTS || (*i)->playerID() == receiverID)
+			(*i)->session()->send(messageData);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameRoom::tickJitter() const
+{
+	return m_tickJitter / 1000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameRoom::simulationCost() const
+{
+	return m_simulationCost / 1000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PlayerProfilePtr GameRoom::playerProfileByID(PlayerID playerID)
+{
+	for (PlayerProfiles::iterator i = m_players.begin(); i != m_players.end();
+		 i++)
+	{
+		if ((*i)->playerID() == playerID)
+			return (*i);
+	}
+
+	return PlayerProfilePtr();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PlayerProfilePtr GameRoom::playerProfileBySession(NetworkServerSession *session)
+{
+	for (PlayerProfiles::iterator i = m_players.begin(); i != m_players.end();
+		 i++)
+	{
+		if ((*i)->session() == session)
+			return (*i);
+	}
+
+	return PlayerProfilePtr();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::scheduleTick()
+{
+	if (!m_isTicking)
+	{
+		// Don't catch up with the time the room was idle
+		m_timestep.restart();
+		m_lastTickTime = 0;
+		m_isTicking = true;
+	}
+
+	m_tickTimer.expires_from_now(boost::posix_time::microseconds(
+		m_timestep.timeUntilNextStep()));
+	m_tickTimer.async_wait(
+		boost::bind(&GameRoom::handleTick, this,
+			boost::asio::placeholders::error));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::handleTick(const boost::system::error_code &error)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+
+	if (error || !m_isRunning || m_players.empty())
+	{
+		m_isTicking = false;
+		return;
+	}
+
+	unsigned int steps = m_timestep.advance();
+
+	if (steps && m_game)
+	{
+		PROFILE_SCOPE("GameRoom::handleTick");
+
+		measureTick();
+
+		{
+			PROFILE_SCOPE("Game::proceed");
+
+			uint64_t start = Clock::microseconds();
+
+			for (unsigned int i = 0; i < steps; i++)
+				m_game->proceed((float)m_timestep.stepLength());
+
+			m_numberOfSteps += steps;
+
+			uint64_t cost = (Clock::microseconds() - start) / steps;
+			m_simulationCost = (uint32_t)(0.9 * m_simulationCost + 0.1 * cost);
+		}
+
+		PROFILE_SCOPE("Game::synchronize");
+		m_game->synchronize(ID_ALL_CLIENTS);
+	}
+
+	scheduleTick();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameRoom::measureTick()
+{
+	uint64_t now = Clock::microseconds();
+
+	if (m_lastTickTime > 0)
+	{
+		int64_t interval = (int64_t)(now - m_lastTickTime);
+		int64_t deviation = interval
+			- (int64_t)(m_timestep.stepLength() * 1000000.0);
+
+		if (deviation < 0)
+			deviation = -deviation;
+
+		m_tickJitter = (uint32_t)(0.9 * m_tickJitter + 0.1 * deviation);
+	}
+
+	m_lastTickTime = now;
+}
@@ -0,0 +1,146 @@
+#ifndef __GAME_GAMEROOM_H
+#define __GAME_GAMEROOM_H
+
+#include <boost/asio.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "GameNetworkInterface.h"
+#include "FixedTimestep.h"
+#include "MatchJournal.h"
+#include "MessageData.h"
+#include "ForwardDeclarations.h"
+
+/**
+ * @class GameRoom
+ *
+ * @brief One game hosted by the game server, with its own players.
+ *
+ * The room is the network interface of its game: messages the game sends only
+ * reach the players of this room, and the player IDs within a room always
+ * start at ID_FIRST_CLIENT. The ticks of the room run as timer handlers on the
+ * server's worker pool. A room only ticks while it has players, and never on
+ * two workers at once.
+ */
+class GameRoom : public GameNetworkInterface
+{
+	public:
+		/** @brief Players a room accepts (one per kind of units). */
+		static unsigned int s_maximalPlayers;
+
+	public:
+		/**
+		 * @brief Creates an empty room.
+		 *
+		 * @param ioService - Worker pool which runs the ticks.
+		 * @param tickInterval - Intended time between two ticks in seconds.
+		 * @param taskScheduler - Threads the simulation steps are split
+		 *     across, or NULL.
+		 */
+		GameRoom(boost::asio::io_service &ioService, double tickInterval,
+			TaskScheduler *taskScheduler);
+		~GameRoom();
+
+		/** @brief Lets the room tick as soon as a player joins. */
+		void run();
+
+		/** @brief Stops ticking and ends the game. */
+		void stop();
+
+		/**
+		 * @brief Loads a level, which begins a new match.
+		 *
+		 * If matches are recorded, the previous journal is finished and a new
+		 * one begins.
+		 */
+		void loadGame(int levelNumber);
+		void startGame();
+
+		/**
+		 * @brief Records the accepted input of each following match.
+		 *
+		 * @param fileNamePrefix - Start of the journal file names, which end
+		 *     with the time the match was loaded.
+		 */
+		void recordMatches(const std::string &fileNamePrefix);
+
+		/**
+		 * @brief Lets a newly connected client join the room.
+		 *
+		 * Sends the client its player ID and the state of the game.
+		 *
+		 * @return false if the room is full.
+		 */
+		bool addPlayer(NetworkServerSession *session);
+
+		void removePlayer(NetworkServerSession *session);
+
+		unsigned int numberOfPlayers();
+
+		void moveUnit(NetworkServerSession *session, uint8_t unitIndex,
+			float angle, float strength);
+		void highlightUnit(NetworkServerSession *session, uint8_t unitIndex,
+			bool isHighlighted);
+
+		/** @copydoc Game::acknowledgeInput */
+		void acknowledgeInput(NetworkServerSession *session,
+			uint16_t inputSequence);
+
+		/**
+		 * @brief Sends a message to players of this room.
+		 *
+		 * Only called by the room's game, while the room is locked.
+		 */
+		void send(MessageData messageData, PlayerID receiverID);
+
+		/** @copydoc GameServer::tickJitter */
+		double tickJitter() const;
+
+		/** @copydoc GameServer::simulationCost */
+		double simulationCost() const;
+
+	protected:
+		PlayerProfilePtr playerProfileByID(PlayerID playerID);
+		PlayerProfilePtr playerProfileBySession(NetworkServerSession *session);
+
+		void scheduleTick();
+		void handleTick(const boost::system::error_code &error);
+
+		void measureTick();
+
+		/** @brief Ends the journal of the current match, if any. */
+		void finishJournal();
+
+		GamePtr m_game;
+		TaskScheduler *m_taskScheduler;
+
+		/** @brief Players of this room, with IDs local to the room. */
+		PlayerProfiles m_players;
+
+		/** @brief Guards the game and the players against the workers. */
+		boost::mutex m_mutex;
+
+		boost::asio::deadline_timer m_tickTimer;
+		FixedTimestep m_timestep;
+
+		bool m_isRunning;
+		bool m_isTicking;
+
+		/** @brief Start of the previous tick (Clock microseconds). */
+		uint64_t m_lastTickTime;
+
+		/** @brief Smoothed tick jitter in microseconds, read by other threads. */
+		boost::atomic<uint32_t> m_tickJitter;
+
+		/** @brief Smoothed time per simulation step in microseconds. */
+		boost::atomic<uint32_t> m_simulationCost;
+
+		/** @brief Steps simulated since the level was loaded. */
+		uint32_t m_numberOfSteps;
+
+		/** @brief Empty if matches are not recorded. */
+		std::string m_journalPrefix;
+		MatchJournal m_matchJournal;
+};
+
+#endif
@@ -4,16 +4,20 @@
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
 
-#include <math.h>
+#include <algorithm>
 
-#include "Game.h"
 #include "GameNetworkServer.h"
+#include "GameRoom.h"
 #include "MoveRequest.h"
 #include "HighlightRequest.h"
-#include "PlayerProfile.h"
-#include "GameUnit.h"
-#include "NewPlayerID.h"
+#include "InputBatch.h"
+#include "Ping.h"
+#include "TaskScheduler.h"
 #include "Logging.h"
+#include "Profiling.h"
+
+// Intended time between two ticks in milliseconds
+const int TICK_INTERVAL = 20;
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -21,6 +25,39 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+GameServer::GameServer(unsigned int numberOfRooms,
+	unsigned int numberOfWorkers)
+{
+	m_gameNetworkServer = nullptr;
+	m_work = nullptr;
+
+	numberOfRooms = std::max(1u, numberOfRooms);
+
+	if (numberOfWorkers == 0)
+		numberOfWorkers = std::max(1u, boost::thread::hardware_concurrency());
+
+	// More workers than rooms would only wait
+	m_numberOfWorkers = std::min(numberOfWorkers, numberOfRooms);
+
+	m_taskScheduler = new TaskScheduler();
+
+	for (unsigned int i = 0; i < numberOfRooms; i++)
+		m_rooms.push_back(GameRoomPtr(new GameRoom(m_ioService,
+			TICK_INTERVAL / 1000.0, m_taskScheduler)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GameServer::~GameServer()
+{
+	stop();
+
+	if (m_taskScheduler)
+		delete m_taskScheduler;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void GameServer::run()
 {
 	m_gameNetworkServer = new GameNetworkServer();
@@ -34,8 +71,19 @@ void GameServer::run()
 
 	initializeMessageHandlers();
 
-	// Start the game server in a new thread
-	boost::thread gameServerThread(boost::bind(&GameServer::loop, this));
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		m_rooms[i]->run();
+
+	// Start the workers which run the ticks of all rooms
+	m_work = new boost::asio::io_service::work(m_ioService);
+
+	for (unsigned int i = 0; i < m_numberOfWorkers; i++)
+		m_workers.create_thread(boost::bind(&GameServer::work, this));
+
+	std::stringstream info;
+	info << "Game server hosts " << m_rooms.size() << " room(s) on "
+		 << m_numberOfWorkers << " worker thread(s).";
+	Logging::info(info.str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,154 +99,261 @@ void GameServer::initializeMessageHandlers()
 		MESSAGE_HIGHLIGHT_REQUEST,
 		MESSAGE_ID_EVENT,
 		boost::bind(&GameServer::handleHighlightRequest, this, _1));
+
+	m_gameNetworkServer->addMessageHandler(
+		MESSAGE_INPUT_BATCH,
+		MESSAGE_ID_EVENT,
+		boost::bind(&GameServer::handleInputBatch, this, _1));
+
+	m_gameNetworkServer->addMessageHandler(
+		MESSAGE_PING,
+		MESSAGE_ID_EVENT,
+		boost::bind(&GameServer::handlePing, this, _1));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::handleMoveRequest(MessageData messageData)
 {
-	MoveRequest moveRequest(NULL);
-	moveRequest.createFromData(messageData);
+	MoveRequest::NetworkData moveRequest;
+
+	if (!MoveRequest::decode(messageData, moveRequest))
+		return;
 
 	NetworkServerSession *session = messageData.networkServerSession();
-	PlayerProfilePtr playerProfile
-		= m_gameNetworkServer->playerProfileBySession(session);
+	GameRoomPtr room = roomBySession(session);
 
-	if (!playerProfile)
+	if (!room)
 	{
 		Logging::error("Received move request from non-player client.");
 		return;
 	}
 
-	GameUnitPtr matchingGameUnit;
+	room->moveUnit(session, moveRequest.unitIndex, moveRequest.angle,
+		moveRequest.strength);
+}
 
-	if (m_game)
-		matchingGameUnit = m_game->unitByIndex(playerProfile->playerID(),
-											   moveRequest.unitIndex());
+////////////////////////////////////////////////////////////////////////////////
 
-	if (!matchingGameUnit)
-	{
-		Logging::error("Game unit requested to move does not exist.");
-		return;
-	}
+void GameServer::handleHighlightRequest(MessageData messageData)
+{
+	HighlightRequest::NetworkData highlightRequest;
 
-	float accelerationX = cos(moveRequest.angle());
-	float accelerationY = -sin(moveRequest.angle());
+	if (!HighlightRequest::decode(messageData, highlightRequest))
+		return;
 
-	float strength = std::min(1.0f, std::max(0.0f, moveRequest.strength()));
+	NetworkServerSession *session = messageData.networkServerSession();
+	GameRoomPtr room = roomBySession(session);
 
-	strength *= GameUnit::s_maximalAcceleration;
+	if (!room)
+	{
+		Logging::error("Received highlight request from non-player client.");
+		return;
+	}
 
-	matchingGameUnit->setAcceleration(cv::Vec2f(accelerationX, accelerationY)
-									  * strength);
+	room->highlightUnit(session, highlightRequest.unitIndex,
+		highlightRequest.isHighlighted);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void GameServer::handleHighlightRequest(MessageData messageData)
+void GameServer::handleInputBatch(MessageData messageData)
 {
-	HighlightRequest highlightRequest(NULL);
-	highlightRequest.createFromData(messageData);
+	InputBatch::NetworkData inputBatch;
+
+	if (!InputBatch::decode(messageData, inputBatch))
+		return;
 
 	NetworkServerSession *session = messageData.networkServerSession();
-	PlayerProfilePtr playerProfile
-		= m_gameNetworkServer->playerProfileBySession(session);
+	GameRoomPtr room = roomBySession(session);
 
-	if (!playerProfile)
+	if (!room)
 	{
-		Logging::error("Received highlight request from non-player client.");
+		Logging::error("Received input batch from non-player client.");
 		return;
 	}
 
-	GameUnitPtr matchingGameUnit;
+	for (unsigned int i = 0; i < inputBatch.numberOfCommands; i++)
+	{
+		const InputBatch::Command &command = inputBatch.commands[i];
 
-	if (m_game)
-		matchingGameUnit = m_game->unitByIndex(playerProfile->playerID(),
-											   highlightRequest.unitIndex());
+		if (command.flags & InputBatch::COMMAND_MOVE)
+			room->moveUnit(session, command.unitIndex, command.angle,
+				command.strength);
 
-	if (!matchingGameUnit)
-	{
-		Logging::error("Game unit requested to be highlighted does not exist.");
-		return;
+		if (command.flags & InputBatch::COMMAND_HIGHLIGHT)
+			room->highlightUnit(session, command.unitIndex,
+				(command.flags & InputBatch::COMMAND_HIGHLIGHTED) != 0);
 	}
 
-	matchingGameUnit->setHighlighted(highlightRequest.isHighlighted());
+	if (inputBatch.sequenceNumber)
+		room->acknowledgeInput(session, inputBatch.sequenceNumber);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameServer::handlePing(MessageData messageData)
+{
+	// Send the ping back unchanged, the client measures the round-trip time
+	Ping ping(m_gameNetworkServer);
+	ping.createFromData(messageData);
+	ping.synchronize(messageData.networkServerSession());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::stop()
 {
-	m_stopMutex.lock();
-	m_game->stop();
-	m_gameNetworkServer->stop();
-	delete m_gameNetworkServer;
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		m_rooms[i]->stop();
+
+	// The workers return as soon as the stopped rooms have no ticks left
+	if (m_work)
+		delete m_work;
+
+	m_work = nullptr;
+
+	m_workers.join_all();
+
+	if (m_gameNetworkServer)
+	{
+		m_gameNetworkServer->stop();
+		delete m_gameNetworkServer;
+	}
+
 	m_gameNetworkServer = nullptr;
-	m_stopMutex.unlock();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void GameServer::loop()
+void GameServer::work()
 {
-	while (true)
-	{
-		m_stopMutex.lock();
-		if(!m_gameNetworkServer) return;
-		boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+	PROFILE_THREAD("game server");
 
-		if (m_game)
-			m_game->proceed();
+	m_ioService.run();
+}
 
-		m_game->synchronize(ID_ALL_CLIENTS);
-		m_stopMutex.unlock();
-	}
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int GameServer::numberOfRooms() const
+{
+	return m_rooms.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void GameServer::processGame(float timeFactor)
+GameRoomPtr GameServer::room(unsigned int index) const
 {
-	if (m_game)
-		m_game->proceed();
+	if (index >= m_rooms.size())
+		return GameRoomPtr();
+
+	return m_rooms[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameServer::tickJitter() const
+{
+	double tickJitter = 0.0;
+
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		tickJitter = std::max(tickJitter, m_rooms[i]->tickJitter());
+
+	return tickJitter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameServer::simulationCost() const
+{
+	double simulationCost = 0.0;
+
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		simulationCost = std::max(simulationCost, m_rooms[i]->simulationCost());
+
+	return simulationCost;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GameRoomPtr GameServer::roomBySession(NetworkServerSession *session)
+{
+	boost::lock_guard<boost::mutex> lock(m_roomsMutex);
+
+	std::map<NetworkServerSession *, GameRoomPtr>::iterator room
+		= m_roomsBySession.find(session);
+
+	if (room == m_roomsBySession.end())
+		return GameRoomPtr();
+
+	return room->second;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::handleSessionAccepted(NetworkServerSession *session)
 {
-	PlayerProfilePtr playerProfile
-		= m_gameNetworkServer->playerProfileBySession(session);
+	boost::lock_guard<boost::mutex> lock(m_roomsMutex);
 
-	if (!playerProfile)
-		return;
+	// Fill up the rooms one after another
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+	{
+		if (!m_rooms[i]->addPlayer(session))
+			continue;
+
+		m_roomsBySession[session] = m_rooms[i];
+
+		std::stringstream info;
+		info << "Client joined room " << i + 1 << ".";
+		Logging::info(info.str());
 
-	NewPlayerID newPlayerID(m_gameNetworkServer);
-	newPlayerID.setPlayerID(playerProfile->playerID());
-	newPlayerID.synchronize(session);
+		return;
+	}
 
-	m_game->synchronize(session);
+	Logging::warning("All game rooms are full, the client cannot play.");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::handleSessionClosed(NetworkServerSession *session)
 {
+	boost::lock_guard<boost::mutex> lock(m_roomsMutex);
 
+	std::map<NetworkServerSession *, GameRoomPtr>::iterator room
+		= m_roomsBySession.find(session);
+
+	if (room == m_roomsBySession.end())
+		return;
+
+	room->second->removePlayer(session);
+	m_roomsBySession.erase(room);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::loadGame(int levelNumber)
 {
-	m_game = GamePtr(new Game(m_gameNetworkServer));
-	m_game->load(levelNumber);
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		m_rooms[i]->loadGame(levelNumber);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameServer::startGame()
 {
-	if (m_game)
-		m_game->start();
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+		m_rooms[i]->startGame();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameServer::recordMatches(const std::string &directory)
+{
+	for (unsigned int i = 0; i < m_rooms.size(); i++)
+	{
+		std::stringstream fileNamePrefix;
+		fileNamePrefix << directory << "/room" << i;
+
+		m_rooms[i]->recordMatches(fileNamePrefix.str());
+	}
 }
@@ -1,8 +1,12 @@
 #ifndef __GAME_GAMESERVER_H
 #define __GAME_GAMESERVER_H
 
+#include <map>
+#include <string>
 #include <vector>
 
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include "MessageData.h"
@@ -15,10 +19,26 @@
  *
  * The game server serves as the game’s backend. It compute the game logic and
  * sends the clients updates about changes in the game.
+ *
+ * It hosts several independent game rooms on one port. A connecting client
+ * joins the first room with a free player slot. The ticks of all rooms share
+ * a pool of worker threads; rooms without players don't tick at all. The
+ * simulation steps of big rooms are additionally split across all cores.
  */
 class GameServer
 {
 	public:
+		/**
+		 * @brief Creates a game server.
+		 *
+		 * @param numberOfRooms - Number of games hosted at the same time.
+		 * @param numberOfWorkers - Threads running the ticks of the rooms, or
+		 *     0 for one per processor core (but not more than rooms).
+		 */
+		GameServer(unsigned int numberOfRooms = 1,
+			unsigned int numberOfWorkers = 0);
+		~GameServer();
+
 		/**
 		 * @brief Runs the game server.
 		 *
@@ -34,24 +54,52 @@ class GameServer
 		 */
 		void stop();
 
+		/** @brief Loads the same level in all rooms. */
+		void loadGame(int levelNumber);
+
+		/** @brief Starts the games of all rooms. */
+		void startGame();
+
 		/**
-		 * @brief The game client’s main loop.
+		 * @brief Records the input of all matches loaded from now on.
 		 *
-		 * Executes the game client’s main loop which eventually renders the
-		 * scene.
+		 * Each room writes one journal per match into the directory, which
+		 * tools/MatchReplay.cpp simulates again.
 		 */
-		void loop();
+		void recordMatches(const std::string &directory);
 
-		void loadGame(int levelNumber);
-		void startGame();
+		unsigned int numberOfRooms() const;
+		GameRoomPtr room(unsigned int index) const;
+
+		/**
+		 * @brief Returns the average deviation of the tick interval.
+		 *
+		 * @return Average absolute difference between the actual and the
+		 *     intended tick interval in milliseconds, of the room where it is
+		 *     largest.
+		 */
+		double tickJitter() const;
+
+		/**
+		 * @brief Returns the average computation time of a simulation step.
+		 *
+		 * @return Time of one Game::proceed call in milliseconds, of the room
+		 *     where it is largest.
+		 */
+		double simulationCost() const;
 
 	protected:
 		void initializeMessageHandlers();
 
 		void handleHighlightRequest(MessageData messageData);
 		void handleMoveRequest(MessageData messageData);
+		void handleInputBatch(MessageData messageData);
+		void handlePing(MessageData messageData);
+
+		GameRoomPtr roomBySession(NetworkServerSession *session);
 
-		void processGame(float timeFactor);
+		/** @brief Runs the ticks of the rooms until the server stops. */
+		void work();
 
 		void handleSessionAccepted(NetworkServerSession *session);
 		void handleSessionClosed(NetworkServerSession *session);
@@ -59,11 +107,24 @@ class GameServer
 		// Components
 		GameNetworkServer *m_gameNetworkServer;
 
-		GamePtr m_game;
+		unsigned int m_numberOfWorkers;
+
+		/** @brief Queue of the tick timers of all rooms. */
+		boost::asio::io_service m_ioService;
+
+		/** @brief Keeps the workers waiting while no room ticks. */
+		boost::asio::io_service::work *m_work;
+
+		boost::thread_group m_workers;
+
+		/** @brief Splits the simulation steps of all rooms across cores. */
+		TaskScheduler *m_taskScheduler;
 
-		PlayerProfiles m_players;
+		GameRooms m_rooms;
 
-		boost::mutex m_stopMutex;
+		/** @brief The room each connected client has joined. */
+		std::map<NetworkServerSession *, GameRoomPtr> m_roomsBySession;
+		boost::mutex m_roomsMutex;
 };
 
 #endif
@@ -1,14 +1,14 @@
 #include "GameUnit.h"
 
-#include <boost/bind.hpp>
-
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "GameNetworkInterface.h"
 #include "GameObstacle.h"
+#include "UnitStates.h"
 #include "Logging.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,19 +24,24 @@ float GameUnit::s_radius = 8.0f;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-GameUnit::GameUnit(GameNetworkInterface *gameNetworkInterface)
-	: Message(gameNetworkInterface)
+GameUnit::GameUnit(UnitStates *unitStates, unsigned int index)
 {
-	// Set up unit data for network transmission via messages
-	registerMessageType(MESSAGE_GAME_UNIT, &m_gameUnitData,
-		sizeof(GameUnitData), UPDATE_FREQUENCY_ALWAYS);
+	m_unitStates = unitStates;
+	m_index = index;
+}
 
-	m_velocity = cv::Vec2f(0.0f, 0.0f);
-	m_acceleration = cv::Vec2f(0.0f, 0.0f);
+////////////////////////////////////////////////////////////////////////////////
 
-	setLiving(true);
-	setArrived(false);
-	setHighlighted(false);
+unsigned int GameUnit::index() const
+{
+	return m_index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MessageID GameUnit::messageID() const
+{
+	return m_unitStates->messageID[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -70,37 +75,10 @@ void GameUnit::render(cv::Mat &image)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void GameUnit::move(float timeDifference)
-{
-	if (!isLiving() || hasArrived())
-	{
-		m_velocity = cv::Vec2f(0.0f, 0.0f);
-		m_acceleration = cv::Vec2f(0.0f, 0.0f);
-
-		return;
-	}
-
-	// Brake the object slightly
-	cv::Vec2f acceleration = m_acceleration - m_velocity * s_brakeFactor;
-
-	m_velocity += acceleration * timeDifference;
-
-	// If the speed exceeds the maximal speed, reset the speed to the maximum
-	float velocityNorm = cv::norm(m_velocity);
-
-	if (velocityNorm > s_maximalVelocity)
-		m_velocity *= s_maximalVelocity / velocityNorm;
-
-	m_gameUnitData.x += m_velocity[0] * timeDifference;
-	m_gameUnitData.y += m_velocity[1] * timeDifference;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 void GameUnit::setPosition(float x, float y)
 {
-	m_gameUnitData.x = x;
-	m_gameUnitData.y = y;
+	m_unitStates->x[m_index] = x;
+	m_unitStates->y[m_index] = y;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -114,119 +92,147 @@ cv::Point GameUnit::position() const
 
 float GameUnit::x() const
 {
-	return m_gameUnitData.x;
+	return m_unitStates->x[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 float &GameUnit::x()
 {
-	return m_gameUnitData.x;
+	return m_unitStates->x[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 float GameUnit::y() const
 {
-	return m_gameUnitData.y;
+	return m_unitStates->y[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 float &GameUnit::y()
 {
-	return m_gameUnitData.y;
+	return m_unitStates->y[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setNumber(uint8_t number)
 {
-	m_gameUnitData.number = number;
+	m_unitStates->number[m_index] = number;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 uint8_t GameUnit::number()
 {
-	return m_gameUnitData.number;
+	return m_unitStates->number[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setOwner(PlayerID owner)
 {
-	m_gameUnitData.owner = owner;
+	m_unitStates->owner[m_index] = owner;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 PlayerID GameUnit::owner() const
 {
-	return m_gameUnitData.owner;
+	return m_unitStates->owner[m_index];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setLiving(bool isLiving)
 {
-	m_gameUnitData.isLiving = isLiving;
+	setFlag(UnitStates::UNIT_LIVING, isLiving);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool GameUnit::isLiving() const
 {
-	return m_gameUnitData.isLiving;
+	return hasFlag(UnitStates::UNIT_LIVING);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setHunting(bool isHunting)
 {
-	m_isHunting = isHunting;
+	setFlag(UnitStates::UNIT_HUNTING, isHunting);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool GameUnit::isHunting() const
 {
-	return m_isHunting;
+	return hasFlag(UnitStates::UNIT_HUNTING);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setHighlighted(bool isHighlighted)
 {
-	m_gameUnitData.isHighlighted = isHighlighted;
+	setFlag(UnitStates::UNIT_HIGHLIGHTED, isHighlighted);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool GameUnit::isHighlighted() const
 {
-	return m_gameUnitData.isHighlighted;
+	return hasFlag(UnitStates::UNIT_HIGHLIGHTED);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setArrived(bool hasArrived)
 {
-	m_gameUnitData.hasArrived = hasArrived;
+	setFlag(UnitStates::UNIT_ARRIVED, hasArrived);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool GameUnit::hasArrived() const
 {
-	return m_gameUnitData.hasArrived;
+	return hasFlag(UnitStates::UNIT_ARRIVED);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void GameUnit::setAcceleration(cv::Vec2f acceleration)
 {
-	m_acceleration = acceleration;
+	m_unitStates->ax[m_index] = acceleration[0];
+	m_unitStates->ay[m_index] = acceleration[1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+cv::Vec2f GameUnit::moveAcceleration(float angle, float strength)
+{
+	strength = std::min(1.0f, std::max(0.0f, strength));
+
+	strength *= s_maximalAcceleration;
+
+	return cv::Vec2f(cos(angle), -sin(angle)) * strength;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameUnit::setFlag(uint8_t flag, bool isSet)
+{
+	uint8_t flags = m_unitStates->flags[m_index];
+
+	m_unitStates->setFlags(m_index, isSet ? (flags | flag) : (flags & ~flag));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool GameUnit::hasFlag(uint8_t flag) const
+{
+	return (m_unitStates->flags[m_index] & flag) != 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -286,19 +292,29 @@ void GameUnit::separateFrom(const GameObstacle &gameObstacle)
 
 void GameUnit::reflectOn(const GameObstacle &gameObstacle)
 {
-	// Compute the axes of collision
+	// Compute the axis of collision
 	cv::Point2f axis1 = position() - gameObstacle.position();
 
 	axis1 = axis1 * (1.0f / norm(axis1));
 
+	reflectOn(cv::Vec2f(axis1.x, axis1.y));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameUnit::reflectOn(cv::Vec2f normal)
+{
 	// Project the velocities of both objects to the axes in order to obtain the
 	// velocity amount in the direction of collision
-	float initialSpeedOnAxis1 = m_velocity.dot(axis1);
+	float &velocityX = m_unitStates->vx[m_index];
+	float &velocityY = m_unitStates->vy[m_index];
+
+	float initialSpeedOnAxis1 = velocityX * normal[0] + velocityY * normal[1];
 
 	// Delete the speed component in the direction of collision. Later, we will
 	// add back the new speed component that has changed due to collision
-	m_velocity[0] -= axis1.x * initialSpeedOnAxis1;
-	m_velocity[1] -= axis1.y * initialSpeedOnAxis1;
+	velocityX -= normal[0] * initialSpeedOnAxis1;
+	velocityY -= normal[1] * initialSpeedOnAxis1;
 
 	// Compute the speed component after collision
 	float finalSpeedOnAxis1;
@@ -306,39 +322,6 @@ void GameUnit::reflectOn(const GameObstacle &gameObstacle)
 	finalSpeedOnAxis1 = -initialSpeedOnAxis1;
 
 	// Add as much speed in the direction of collision as we previously computed
-	m_velocity[0] += axis1.x * fabs(finalSpeedOnAxis1);
-	m_velocity[1] += axis1.y * fabs(finalSpeedOnAxis1);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void GameUnit::reflectOnWalls()
-{
-	if (x() < s_radius / 2)
-	{
-		x() = s_radius / 2;
-
-		m_velocity[0] = -m_velocity[0];
-	}
-
-	if (x() > 480 - s_radius / 2)
-	{
-		x() = 480 - s_radius / 2;
-
-		m_velocity[0] = -m_velocity[0];
-	}
-
-	if (y() < s_radius / 2)
-	{
-		y() = s_radius / 2;
-
-		m_velocity[1] = -m_velocity[1];
-	}
-
-	if (y() > 480 - s_radius / 2)
-	{
-		y() = 480 - s_radius / 2;
-
-		m_velocity[1] = -m_velocity[1];
-	}
+	velocityX += normal[0] * fabs(finalSpeedOnAxis1);
+	velocityY += normal[1] * fabs(finalSpeedOnAxis1);
 }
@@ -5,11 +5,18 @@
 
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "Message.h"
 #include "MessageData.h"
 #include "ForwardDeclarations.h"
 
-class GameUnit : public Message
+/**
+ * @class GameUnit
+ *
+ * @brief View of one unit in the game's UnitStates.
+ *
+ * A game unit only refers to an index in the state arrays, so it is cheap to
+ * create. It stays valid until the game's units are reset.
+ */
+class GameUnit
 {
 	public:
 		static float s_maximalVelocity;
@@ -18,11 +25,12 @@ class GameUnit : public Message
 		static float s_radius;
 
 	public:
-		GameUnit(GameNetworkInterface *gameNetworkInterface);
+		GameUnit(UnitStates *unitStates, unsigned int index);
 
-		void render(cv::Mat &image);
+		unsigned int index() const;
+		MessageID messageID() const;
 
-		void move(float timeDifference);
+		void render(cv::Mat &image);
 
 		void setPosition(float x, float y);
 		cv::Point position() const;
@@ -51,35 +59,35 @@ class GameUnit : public Message
 
 		void setAcceleration(cv::Vec2f acceleration);
 
+		/**
+		 * @brief Returns the acceleration a move request results in.
+		 *
+		 * @param angle - Direction in radians, counterclockwise from the x
+		 *     axis.
+		 * @param strength - Fraction of the maximal acceleration, clamped to
+		 *     [0, 1].
+		 */
+		static cv::Vec2f moveAcceleration(float angle, float strength);
+
 		bool collidesWith(const GameUnit &otherGameUnit);
 		bool collidesWith(const GameObstacle &gameObstacle);
 
 		void separateFrom(const GameObstacle &gameObstacle);
 		void reflectOn(const GameObstacle &gameObstacle);
 
-		void reflectOnWalls();
+		/**
+		 * @brief Makes the unit bounce off a surface.
+		 *
+		 * @param normal - Unit length direction pointing away from the surface.
+		 */
+		void reflectOn(cv::Vec2f normal);
 
 	protected:
-		// Data to synchronize via network
-		struct GameUnitData
-		{
-			float x;
-			float y;
-
-			uint8_t number;
-			PlayerID owner;
-
-			bool isHighlighted;
-			bool isLiving;
-			bool hasArrived;
-		};
-
-		cv::Vec2f m_velocity;
-		cv::Vec2f m_acceleration;
-
-		bool m_isHunting;
+		void setFlag(uint8_t flag, bool isSet);
+		bool hasFlag(uint8_t flag) const;
 
-		GameUnitData m_gameUnitData;
+		UnitStates *m_unitStates;
+		unsigned int m_index;
 };
 
 #endif
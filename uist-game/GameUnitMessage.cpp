@@ -0,0 +1,92 @@
+#include "GameUnitMessage.h"
+
+#include <algorithm>
+
+#include "MessageTypes.h"
+#include "UnitStates.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// GameUnitMessage
+//
+////////////////////////////////////////////////////////////////////////////////
+
+GameUnitMessage::GameUnitMessage(GameNetworkInterface *gameNetworkInterface)
+	: Message(gameNetworkInterface)
+{
+	m_networkData.time = 0;
+	m_networkData.x = 0;
+	m_networkData.y = 0;
+	m_networkData.vx = 0;
+	m_networkData.vy = 0;
+	m_networkData.number = 0;
+	m_networkData.flags = 0;
+	m_networkData.owner = ID_NONE;
+	m_networkData.inputSequence = 0;
+	m_networkData.inputAge = 0;
+
+	// Set up for network transmission via messages
+	registerMessageType(MESSAGE_GAME_UNIT, &m_networkData,
+		sizeof(NetworkData), UPDATE_FREQUENCY_ALWAYS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameUnitMessage::setUnit(const UnitStates &unitStates, unsigned int index,
+	double time)
+{
+	m_networkData.time = (float)time;
+	m_networkData.x = unitStates.x[index];
+	m_networkData.y = unitStates.y[index];
+	m_networkData.vx = unitStates.vx[index];
+	m_networkData.vy = unitStates.vy[index];
+	m_networkData.number = unitStates.number[index];
+	m_networkData.flags = unitStates.flags[index];
+	m_networkData.owner = unitStates.owner[index];
+
+	setSentMessageID(unitStates.messageID[index]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameUnitMessage::updateUnit(UnitStates &unitStates,
+	unsigned int index) const
+{
+	unitStates.x[index] = m_networkData.x;
+	unitStates.y[index] = m_networkData.y;
+	unitStates.vx[index] = m_networkData.vx;
+	unitStates.vy[index] = m_networkData.vy;
+	unitStates.number[index] = m_networkData.number;
+	unitStates.setFlags(index, m_networkData.flags);
+	unitStates.owner[index] = m_networkData.owner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameUnitMessage::time() const
+{
+	return m_networkData.time;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GameUnitMessage::setInput(uint16_t inputSequence, double inputAge)
+{
+	m_networkData.inputSequence = inputSequence;
+	m_networkData.inputAge = (uint16_t)std::min(std::max(inputAge * 1000.0,
+		0.0), 65535.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint16_t GameUnitMessage::inputSequence() const
+{
+	return m_networkData.inputSequence;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GameUnitMessage::inputAge() const
+{
+	return m_networkData.inputAge / 1000.0;
+}
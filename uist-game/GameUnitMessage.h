@@ -0,0 +1,76 @@
+#ifndef __GAME_GAMEUNITMESSAGE_H
+#define __GAME_GAMEUNITMESSAGE_H
+
+#include "Message.h"
+#include "ForwardDeclarations.h"
+
+/**
+ * @class GameUnitMessage
+ *
+ * @brief Network view of one unit in a UnitStates.
+ *
+ * One instance can send any number of units one after another, so units do
+ * not need to be messages themselves.
+ */
+class GameUnitMessage : public Message
+{
+	public:
+		GameUnitMessage(GameNetworkInterface *gameNetworkInterface);
+
+		/**
+		 * @brief Loads a unit's state and message ID for sending.
+		 *
+		 * @param unitStates - The states to read from.
+		 * @param index - Index of the unit.
+		 * @param time - Server simulation time of the state in seconds.
+		 */
+		void setUnit(const UnitStates &unitStates, unsigned int index,
+			double time);
+
+		/**
+		 * @brief Writes the received state into a unit.
+		 *
+		 * @param unitStates - The states to write to.
+		 * @param index - Index of the unit.
+		 */
+		void updateUnit(UnitStates &unitStates, unsigned int index) const;
+
+		/** @brief Returns the server simulation time of the state. */
+		double time() const;
+
+		/**
+		 * @brief Tells the owner which of its input the state contains.
+		 *
+		 * @param inputSequence - Sequence number of the owner's last applied
+		 *     input batch, 0 if none.
+		 * @param inputAge - Simulated seconds since that batch was applied.
+		 */
+		void setInput(uint16_t inputSequence, double inputAge);
+
+		uint16_t inputSequence() const;
+		double inputAge() const;
+
+	protected:
+		struct NetworkData
+		{
+			float time;
+
+			float x;
+			float y;
+			float vx;
+			float vy;
+
+			uint8_t number;
+			uint8_t flags;
+			PlayerID owner;
+
+			uint16_t inputSequence;
+
+			/** @brief In milliseconds. */
+			uint16_t inputAge;
+		};
+
+		NetworkData m_networkData;
+};
+
+#endif
@@ -49,3 +49,11 @@ bool HighlightRequest::isHighlighted()
 {
 	return m_networkData.isHighlighted;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool HighlightRequest::decode(MessageData &messageData, NetworkData &networkData)
+{
+	return Message::decode(messageData, MESSAGE_HIGHLIGHT_REQUEST, &networkData,
+		sizeof(NetworkData));
+}
@@ -7,6 +7,20 @@
 class HighlightRequest : public Message
 {
 	public:
+		/** @brief Content of the message. */
+		struct NetworkData
+		{
+			uint8_t unitIndex;
+			bool isHighlighted;
+		};
+
+		/**
+		 * @brief Reads a received request without constructing a message.
+		 *
+		 * @return False if the message data is no valid request.
+		 */
+		static bool decode(MessageData &messageData, NetworkData &networkData);
+
 		HighlightRequest(GameNetworkInterface *gameNetworkInterface);
 
 		void setUnitIndex(uint8_t unitIndex);
@@ -16,12 +30,6 @@ class HighlightRequest : public Message
 		bool isHighlighted();
 
 	protected:
-		struct NetworkData
-		{
-			uint8_t unitIndex;
-			bool isHighlighted;
-		};
-
 		NetworkData m_networkData;
 };
 
@@ -0,0 +1,121 @@
+#include "InputBatch.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/bind.hpp>
+
+#include "MessageTypes.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// InputBatch
+//
+////////////////////////////////////////////////////////////////////////////////
+
+InputBatch::InputBatch(GameNetworkInterface *gameNetworkInterface)
+	: Message(gameNetworkInterface)
+{
+	m_networkData.sequenceNumber = 0;
+	m_networkData.numberOfCommands = 0;
+
+	// Set up for network transmission via messages
+	registerMessageType(MESSAGE_INPUT_BATCH, &m_networkData,
+		sizeof(NetworkData), UPDATE_FREQUENCY_ONCE);
+
+	setMessageID(MESSAGE_ID_EVENT);
+
+	updateContentLength();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool InputBatch::decode(MessageData &messageData, NetworkData &networkData)
+{
+	if (!Message::decode(messageData, MESSAGE_INPUT_BATCH, &networkData,
+			sizeof(NetworkData)))
+		return false;
+
+	// Never trust the count of received batches
+	networkData.numberOfCommands = std::min<unsigned int>(
+		networkData.numberOfCommands, s_maximalCommands);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool InputBatch::addCommand(const Command &command)
+{
+	if (isFull())
+		return false;
+
+	m_networkData.commands[m_networkData.numberOfCommands++] = command;
+
+	updateContentLength();
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InputBatch::clear()
+{
+	m_networkData.numberOfCommands = 0;
+
+	updateContentLength();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InputBatch::setSequenceNumber(uint16_t sequenceNumber)
+{
+	m_networkData.sequenceNumber = sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint16_t InputBatch::sequenceNumber()
+{
+	return m_networkData.sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int InputBatch::numberOfCommands()
+{
+	// Never trust the count of received batches
+	return std::min<unsigned int>(m_networkData.numberOfCommands,
+		s_maximalCommands);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const InputBatch::Command &InputBatch::command(unsigned int index)
+{
+	return m_networkData.commands[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool InputBatch::isEmpty()
+{
+	return m_networkData.numberOfCommands == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool InputBatch::isFull()
+{
+	return m_networkData.numberOfCommands >= s_maximalCommands;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InputBatch::updateContentLength()
+{
+	// Only send the commands in use instead of the whole array
+	setContentLength(MESSAGE_INPUT_BATCH,
+		(ContentLength)(offsetof(NetworkData, commands)
+			+ numberOfCommands() * sizeof(Command)));
+}
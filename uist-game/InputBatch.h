@@ -0,0 +1,91 @@
+#ifndef __GAME_INPUTBATCH_H
+#define __GAME_INPUTBATCH_H
+
+#include "Message.h"
+#include "ForwardDeclarations.h"
+
+/**
+ * @class InputBatch
+ *
+ * @brief All unit commands of one client frame in a single message.
+ *
+ * Each command can move and/or highlight one unit. Only the commands actually
+ * added are transmitted.
+ */
+class InputBatch : public Message
+{
+	public:
+		/** @brief What a command changes. */
+		enum
+		{
+			COMMAND_MOVE = 1 << 0,
+			COMMAND_HIGHLIGHT = 1 << 1,
+
+			/** @brief New highlight state if COMMAND_HIGHLIGHT is set. */
+			COMMAND_HIGHLIGHTED = 1 << 2
+		};
+
+		struct Command
+		{
+			uint8_t unitIndex;
+			uint8_t flags;
+			float angle;
+			float strength;
+		};
+
+		/** @brief Number of commands fitting into one batch. */
+		static const unsigned int s_maximalCommands = 32;
+
+		/** @brief Content of the message. */
+		struct NetworkData
+		{
+			uint16_t sequenceNumber;
+			uint8_t numberOfCommands;
+			Command commands[s_maximalCommands];
+		};
+
+		/**
+		 * @brief Reads a received batch without constructing a message.
+		 *
+		 * The number of commands is limited to s_maximalCommands.
+		 *
+		 * @return False if the message data is no valid batch.
+		 */
+		static bool decode(MessageData &messageData, NetworkData &networkData);
+
+		InputBatch(GameNetworkInterface *gameNetworkInterface);
+
+		/**
+		 * @brief Appends a command to the batch.
+		 *
+		 * @param command - The command to append.
+		 *
+		 * @return False if the batch is full.
+		 */
+		bool addCommand(const Command &command);
+
+		void clear();
+
+		/**
+		 * @brief Numbers the batch, so that the server can report which
+		 * input its unit states already contain.
+		 *
+		 * @param sequenceNumber - Increases with each frame's input, 0 for
+		 *     unnumbered batches.
+		 */
+		void setSequenceNumber(uint16_t sequenceNumber);
+		uint16_t sequenceNumber();
+
+		unsigned int numberOfCommands();
+		const Command &command(unsigned int index);
+
+		bool isEmpty();
+		bool isFull();
+
+	protected:
+		void updateContentLength();
+
+		NetworkData m_networkData;
+};
+
+#endif
@@ -0,0 +1,290 @@
+#include "LevelFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Logging.h"
+
+std::string LevelFile::s_directory = "levels";
+
+const char LEVEL_MAGIC[4] = {'F', 'S', 'L', 'V'};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// LevelFile
+//
+////////////////////////////////////////////////////////////////////////////////
+
+LevelFile::LevelFile()
+{
+	m_fileMapping = NULL;
+	m_mappedRegion = NULL;
+
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LevelFile::~LevelFile()
+{
+	close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string LevelFile::fileName(int levelNumber)
+{
+	const char *extensions[] = {".level", ".txt"};
+
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		std::stringstream fileName;
+		fileName << s_directory << "/level" << levelNumber << extensions[i];
+
+		if (std::ifstream(fileName.str().c_str()))
+			return fileName.str();
+	}
+
+	return std::string();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool LevelFile::open(const std::string &fileName)
+{
+	close();
+
+	try
+	{
+		m_fileMapping = new boost::interprocess::file_mapping(fileName.c_str(),
+			boost::interprocess::read_only);
+		m_mappedRegion = new boost::interprocess::mapped_region(*m_fileMapping,
+			boost::interprocess::read_only);
+	}
+	catch (boost::interprocess::interprocess_exception &exception)
+	{
+		Logging::error("Could not map level file " + fileName + ": "
+			+ exception.what());
+
+		close();
+		return false;
+	}
+
+	const char *data = (const char *)m_mappedRegion->get_address();
+	size_t size = m_mappedRegion->get_size();
+
+	bool isBinary = (size >= sizeof(LEVEL_MAGIC)
+		&& memcmp(data, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) == 0);
+
+	bool isValid = isBinary ? openBinary(data, size) : openText(data, size);
+
+	if (!isValid)
+	{
+		Logging::error("Invalid level file " + fileName + ".");
+
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool LevelFile::openBinary(const char *data, size_t size)
+{
+	if (size < sizeof(Header))
+		return false;
+
+	const Header *header = (const Header *)data;
+
+	if (header->version != s_version)
+		return false;
+
+	size_t unitsSize = (size_t)header->numberOfUnits * sizeof(Unit);
+	size_t obstaclesSize = (size_t)header->numberOfObstacles * sizeof(Obstacle);
+
+	if (size < sizeof(Header) + unitsSize + obstaclesSize)
+		return false;
+
+	// The records are used right where they are mapped
+	m_units = (const Unit *)(data + sizeof(Header));
+	m_numberOfUnits = header->numberOfUnits;
+	m_obstacles = (const Obstacle *)(data + sizeof(Header) + unitsSize);
+	m_numberOfObstacles = header->numberOfObstacles;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool LevelFile::openText(const char *data, size_t size)
+{
+	std::istringstream text(std::string(data, size));
+	std::string line;
+
+	while (std::getline(text, line))
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream words(line);
+		std::string kind;
+
+		if (!(words >> kind))
+			continue;
+
+		float x;
+		float y;
+
+		if (!(words >> x >> y))
+			return false;
+
+		if (kind == "sheep" || kind == "hunter")
+		{
+			addUnit(x, y, kind == "hunter");
+		}
+		else if (kind == "obstacle")
+		{
+			float radius;
+
+			if (!(words >> radius))
+				return false;
+
+			addObstacle(x, y, radius);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	// The text is parsed, the mapping is not needed anymore
+	delete m_mappedRegion;
+	m_mappedRegion = NULL;
+	delete m_fileMapping;
+	m_fileMapping = NULL;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool LevelFile::save(const std::string &fileName) const
+{
+	std::ofstream file(fileName.c_str(), std::ios::binary);
+
+	if (!file)
+		return false;
+
+	Header header;
+	memcpy(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+	header.version = s_version;
+	header.numberOfUnits = m_numberOfUnits;
+	header.numberOfObstacles = m_numberOfObstacles;
+
+	file.write((const char *)&header, sizeof(Header));
+	file.write((const char *)m_units, m_numberOfUnits * sizeof(Unit));
+	file.write((const char *)m_obstacles,
+		m_numberOfObstacles * sizeof(Obstacle));
+
+	return file.good();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LevelFile::close()
+{
+	if (m_mappedRegion)
+		delete m_mappedRegion;
+
+	if (m_fileMapping)
+		delete m_fileMapping;
+
+	m_mappedRegion = NULL;
+	m_fileMapping = NULL;
+
+	m_ownUnits.clear();
+	m_ownObstacles.clear();
+
+	m_nextNumber[0] = 1;
+	m_nextNumber[1] = 1;
+
+	updateView();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LevelFile::addUnit(float x, float y, bool isHunting)
+{
+	Unit unit;
+	unit.x = x;
+	unit.y = y;
+	unit.isHunting = isHunting ? 1 : 0;
+	unit.number = m_nextNumber[unit.isHunting]++;
+	unit.reserved[0] = 0;
+	unit.reserved[1] = 0;
+
+	// Numbers are a single byte, start over after 255
+	if (m_nextNumber[unit.isHunting] == 0)
+		m_nextNumber[unit.isHunting] = 1;
+
+	m_ownUnits.push_back(unit);
+
+	updateView();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LevelFile::addObstacle(float x, float y, float radius)
+{
+	Obstacle obstacle;
+	obstacle.x = x;
+	obstacle.y = y;
+	obstacle.radius = radius;
+
+	m_ownObstacles.push_back(obstacle);
+
+	updateView();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LevelFile::updateView()
+{
+	m_units = m_ownUnits.empty() ? NULL : &m_ownUnits[0];
+	m_numberOfUnits = m_ownUnits.size();
+	m_obstacles = m_ownObstacles.empty() ? NULL : &m_ownObstacles[0];
+	m_numberOfObstacles = m_ownObstacles.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int LevelFile::numberOfUnits() const
+{
+	return m_numberOfUnits;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const LevelFile::Unit *LevelFile::units() const
+{
+	return m_units;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int LevelFile::numberOfObstacles() const
+{
+	return m_numberOfObstacles;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const LevelFile::Obstacle *LevelFile::obstacles() const
+{
+	return m_obstacles;
+}
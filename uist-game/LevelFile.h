@@ -0,0 +1,136 @@
+#ifndef __GAME_LEVELFILE_H
+#define __GAME_LEVELFILE_H
+
+#include <string>
+#include <vector>
+
+#include "MessageData.h"
+
+namespace boost
+{
+	namespace interprocess
+	{
+		class file_mapping;
+		class mapped_region;
+	}
+}
+
+/**
+ * @class LevelFile
+ *
+ * @brief Units and obstacles of one level.
+ *
+ * Levels are either authored as text or compiled to a binary file (see
+ * tools/LevelCompiler.cpp). A binary file is memory-mapped and its records
+ * are used in place, so even levels with thousands of units are loaded
+ * without parsing or allocating anything per object. Text files are parsed
+ * into memory owned by the level file.
+ *
+ * Text format, one object per line, # starts a comment:
+ *
+ *     sheep <x> <y>
+ *     hunter <x> <y>
+ *     obstacle <x> <y> <radius>
+ *
+ * The binary format is a Header followed by the Unit and Obstacle records,
+ * all in the byte order of the machine that compiled the level.
+ */
+class LevelFile
+{
+	public:
+		/** @brief Directory the level files are searched in. */
+		static std::string s_directory;
+
+		static const uint32_t s_version = 1;
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t numberOfUnits;
+			uint32_t numberOfObstacles;
+		};
+
+		struct Unit
+		{
+			float x;
+			float y;
+
+			/** @brief 1 if the unit is a hunter, 0 if it is a sheep. */
+			uint8_t isHunting;
+
+			/** @brief Number shown on the unit, counted per kind. */
+			uint8_t number;
+
+			uint8_t reserved[2];
+		};
+
+		struct Obstacle
+		{
+			float x;
+			float y;
+			float radius;
+		};
+
+	public:
+		LevelFile();
+		~LevelFile();
+
+		/**
+		 * @brief Finds the file of a level number.
+		 *
+		 * A compiled level (levelN.level) is preferred over its text source
+		 * (levelN.txt).
+		 *
+		 * @return The file name, or an empty string if there is no such level.
+		 */
+		static std::string fileName(int levelNumber);
+
+		/**
+		 * @brief Opens a binary or text level file.
+		 *
+		 * @return false if the file could not be read or is malformed.
+		 */
+		bool open(const std::string &fileName);
+
+		/**
+		 * @brief Writes the level in the binary format.
+		 *
+		 * @return false if the file could not be written.
+		 */
+		bool save(const std::string &fileName) const;
+
+		void close();
+
+		void addUnit(float x, float y, bool isHunting);
+		void addObstacle(float x, float y, float radius);
+
+		unsigned int numberOfUnits() const;
+		const Unit *units() const;
+
+		unsigned int numberOfObstacles() const;
+		const Obstacle *obstacles() const;
+
+	protected:
+		bool openBinary(const char *data, size_t size);
+		bool openText(const char *data, size_t size);
+
+		void updateView();
+
+		boost::interprocess::file_mapping *m_fileMapping;
+		boost::interprocess::mapped_region *m_mappedRegion;
+
+		// Records of text files and added objects
+		std::vector<Unit> m_ownUnits;
+		std::vector<Obstacle> m_ownObstacles;
+
+		uint8_t m_nextNumber[2];
+
+		// Either points into the mapped file or to the own records
+		const Unit *m_units;
+		unsigned int m_numberOfUnits;
+		const Obstacle *m_obstacles;
+		unsigned int m_numberOfObstacles;
+};
+
+#endif
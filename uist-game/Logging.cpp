@@ -14,6 +14,13 @@ Logging *Logging::s_instance = NULL;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Logging::Logging()
+{
+	m_level = Level::LEVEL_DEBUG;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 Logging *Logging::instance()
 {
 	if (!s_instance)
@@ -26,6 +33,9 @@ Logging *Logging::instance()
 
 void Logging::log(std::string text, int level)
 {
+	if (level > m_level.load())
+		return;
+
 	boost::lock_guard<boost::mutex> lock(m_loggingMutex);
 
 	switch (level)
@@ -79,3 +89,10 @@ void Logging::debug(std::string text)
 {
 	instance()->log(text, Level::LEVEL_DEBUG);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Logging::setLevel(int level)
+{
+	instance()->m_level.store(level);
+}
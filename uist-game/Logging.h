@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include <boost/atomic.hpp>
 #include <boost/thread/mutex.hpp>
 
 /**
@@ -39,7 +40,20 @@ class Logging
 			enum {LEVEL_ERROR, LEVEL_WARNING, LEVEL_INFO, LEVEL_DEBUG};
 		};
 
+		/**
+		 * @brief Sets the least important level which is still logged.
+		 *
+		 * Messages of less important levels are dropped, e. g. the
+		 * information of every single match in a headless batch of
+		 * simulations. By default, all messages are logged.
+		 *
+		 * @param level - One of the values in Level.
+		 */
+		static void setLevel(int level);
+
 	protected:
+		Logging();
+
 		/** @brief The singleton instance of the logging class. */
 		static Logging *s_instance;
 
@@ -93,6 +107,10 @@ class Logging
 	protected:
 		/** @brief Mutex providing thread-safe logging. */
 		boost::mutex m_loggingMutex;
+
+		/** @brief Least important level which is logged; read without
+		 * the mutex by every thread that logs. */
+		boost::atomic<int> m_level;
 };
 
 #endif
@@ -0,0 +1,209 @@
+#include "MatchJournal.h"
+
+#include <cstring>
+
+#include "Logging.h"
+
+const char JOURNAL_MAGIC[4] = {'F', 'S', 'M', 'J'};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MatchJournal
+//
+////////////////////////////////////////////////////////////////////////////////
+
+MatchJournal::MatchJournal()
+{
+	memcpy(m_header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+	m_header.version = s_version;
+	m_header.levelNumber = 0;
+	m_header.stepLength = 0.0f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MatchJournal::~MatchJournal()
+{
+	// A journal without its end record can still be replayed
+	if (m_file.is_open())
+		m_file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MatchJournal::create(const std::string &fileName, int levelNumber,
+	float stepLength)
+{
+	if (m_file.is_open())
+		m_file.close();
+
+	m_records.clear();
+
+	m_header.levelNumber = levelNumber;
+	m_header.stepLength = stepLength;
+
+	m_file.open(fileName.c_str(), std::ios::binary | std::ios::trunc);
+
+	if (!m_file)
+	{
+		Logging::error("Could not create match journal " + fileName + ".");
+		return false;
+	}
+
+	m_file.write((const char *)&m_header, sizeof(Header));
+
+	return m_file.good();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MatchJournal::isRecording() const
+{
+	return m_file.is_open();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MatchJournal::recordStart(uint32_t step)
+{
+	Record record;
+	memset(&record, 0, sizeof(Record));
+	record.step = step;
+	record.type = RECORD_START;
+
+	write(record);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MatchJournal::recordMove(uint32_t step, PlayerID playerID,
+	uint8_t unitIndex, float angle, float strength)
+{
+	Record record;
+	memset(&record, 0, sizeof(Record));
+	record.step = step;
+	record.type = RECORD_MOVE;
+	record.unitIndex = unitIndex;
+	record.playerID = playerID;
+	record.angle = angle;
+	record.strength = strength;
+
+	write(record);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MatchJournal::recordHighlight(uint32_t step, PlayerID playerID,
+	uint8_t unitIndex, bool isHighlighted)
+{
+	Record record;
+	memset(&record, 0, sizeof(Record));
+	record.step = step;
+	record.type = RECORD_HIGHLIGHT;
+	record.unitIndex = unitIndex;
+	record.playerID = playerID;
+	record.angle = isHighlighted ? 1.0f : 0.0f;
+	record.strength = 0.0f;
+
+	write(record);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MatchJournal::close(uint32_t step)
+{
+	if (!m_file.is_open())
+		return;
+
+	Record record;
+	memset(&record, 0, sizeof(Record));
+	record.step = step;
+	record.type = RECORD_END;
+
+	write(record);
+
+	m_file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MatchJournal::write(const Record &record)
+{
+	// Written through the stream's buffer, which is only flushed once full
+	if (m_file.is_open())
+		m_file.write((const char *)&record, sizeof(Record));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MatchJournal::open(const std::string &fileName)
+{
+	m_records.clear();
+
+	std::ifstream file(fileName.c_str(), std::ios::binary);
+
+	if (!file)
+	{
+		Logging::error("Could not open match journal " + fileName + ".");
+		return false;
+	}
+
+	Header header;
+
+	if (!file.read((char *)&header, sizeof(Header))
+		|| memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC))
+		|| header.version != s_version)
+	{
+		Logging::error(fileName + " is no match journal of this version.");
+		return false;
+	}
+
+	m_header = header;
+
+	// A record cut off by a crash is ignored
+	Record record;
+
+	while (file.read((char *)&record, sizeof(Record)))
+		m_records.push_back(record);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int MatchJournal::levelNumber() const
+{
+	return m_header.levelNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+float MatchJournal::stepLength() const
+{
+	return m_header.stepLength;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t MatchJournal::numberOfSteps() const
+{
+	if (m_records.empty())
+		return 0;
+
+	// Records are in the order of their steps
+	return m_records.back().step;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int MatchJournal::numberOfRecords() const
+{
+	return m_records.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const MatchJournal::Record &MatchJournal::record(unsigned int index) const
+{
+	return m_records[index];
+}
@@ -0,0 +1,115 @@
+#ifndef __GAME_MATCHJOURNAL_H
+#define __GAME_MATCHJOURNAL_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MessageData.h"
+
+/**
+ * @class MatchJournal
+ *
+ * @brief All input a game room accepted during one match.
+ *
+ * The simulation is deterministic, so the level, the step length and the
+ * accepted requests with the step they were applied before are enough to
+ * simulate the match again (see tools/MatchReplay.cpp). The game has no
+ * random numbers, so there is no seed to store.
+ *
+ * The file is a Header followed by Record entries, in the byte order of the
+ * machine that recorded the match. The last record is RECORD_END with the
+ * total number of steps, unless the server did not shut down properly.
+ */
+class MatchJournal
+{
+	public:
+		static const uint32_t s_version = 1;
+
+		/** @brief Kinds of records. */
+		enum
+		{
+			RECORD_START = 1,
+			RECORD_MOVE,
+			RECORD_HIGHLIGHT,
+			RECORD_END
+		};
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			int32_t levelNumber;
+
+			/** @brief Simulated seconds per step. */
+			float stepLength;
+		};
+
+		struct Record
+		{
+			/** @brief Number of steps simulated before the record. */
+			uint32_t step;
+
+			uint8_t type;
+			uint8_t unitIndex;
+			PlayerID playerID;
+
+			/** @brief Move direction, or 1 to highlight and 0 to unhighlight. */
+			float angle;
+			float strength;
+		};
+
+	public:
+		MatchJournal();
+		~MatchJournal();
+
+		/**
+		 * @brief Starts recording a new match.
+		 *
+		 * @return false if the file could not be created.
+		 */
+		bool create(const std::string &fileName, int levelNumber,
+			float stepLength);
+
+		bool isRecording() const;
+
+		void recordStart(uint32_t step);
+		void recordMove(uint32_t step, PlayerID playerID, uint8_t unitIndex,
+			float angle, float strength);
+		void recordHighlight(uint32_t step, PlayerID playerID,
+			uint8_t unitIndex, bool isHighlighted);
+
+		/**
+		 * @brief Finishes the recording.
+		 *
+		 * @param step - Total number of steps of the match.
+		 */
+		void close(uint32_t step);
+
+		/**
+		 * @brief Reads a recorded match.
+		 *
+		 * @return false if the file could not be read or is malformed.
+		 */
+		bool open(const std::string &fileName);
+
+		int levelNumber() const;
+		float stepLength() const;
+
+		/** @brief Returns the steps of the match, including the last ones
+		 * without any input. */
+		uint32_t numberOfSteps() const;
+
+		unsigned int numberOfRecords() const;
+		const Record &record(unsigned int index) const;
+
+	protected:
+		void write(const Record &record);
+
+		std::ofstream m_file;
+
+		Header m_header;
+		std::vector<Record> m_records;
+};
+
+#endif
@@ -1,5 +1,9 @@
 #include "Message.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include <boost/bind.hpp>
 #include <boost/thread/lock_guard.hpp>
 
@@ -13,7 +17,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // The first message will receive the first allowed ID
-MessageID Message::s_nextMessageID = MESSAGE_ID_FIRST;
+uint32_t Message::s_nextMessageID = MESSAGE_ID_FIRST;
+
+boost::mutex Message::s_nextMessageIDMutex;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -58,6 +64,13 @@ void Message::updateData(MessageData messageData)
 
 			if ((*i).header.contentType == messageData.contentType())
 			{
+				// Never write beyond the registered data
+				if (messageData.contentLength() > (*i).capacity)
+				{
+					Logging::error("Received message data is too long.");
+					return;
+				}
+
 				messageData.copyTo((*i).data);
 				break;
 			}
@@ -178,6 +191,7 @@ void Message::registerMessageType(ContentType contentType,
 	newRegisteredMessageType.isSendingEnabled = true;
 	newRegisteredMessageType.header = newMessageHeader;
 	newRegisteredMessageType.data = data;
+	newRegisteredMessageType.capacity = contentLength;
 	newRegisteredMessageType.updateFrequency = updateFrequency;
 
 	boost::lock_guard<boost::mutex> lock(m_registeredMessageTypesMutex);
@@ -187,6 +201,44 @@ void Message::registerMessageType(ContentType contentType,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Message::setContentLength(ContentType contentType,
+	ContentLength contentLength)
+{
+	boost::lock_guard<boost::mutex> lock(m_registeredMessageTypesMutex);
+
+	for (RegisteredMessageTypes::iterator i = m_registeredMessageTypes.begin();
+		i != m_registeredMessageTypes.end(); i++)
+	{
+		if ((*i).header.contentType == contentType)
+			(*i).header.contentLength = std::min(contentLength, (*i).capacity);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Message::decode(MessageData &messageData, ContentType contentType,
+	void *data, ContentLength capacity)
+{
+	if (messageData.contentType() != contentType)
+		return false;
+
+	ContentLength contentLength = messageData.contentLength();
+
+	// Never write beyond the struct
+	if (contentLength > capacity)
+	{
+		Logging::error("Received message data is too long.");
+		return false;
+	}
+
+	messageData.copyTo(data);
+	memset((char *)data + contentLength, 0, capacity - contentLength);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Message::enableSendingMessageType(ContentType contentType)
 {
 	boost::lock_guard<boost::mutex> lock(m_registeredMessageTypesMutex);
@@ -218,7 +270,34 @@ void Message::disableSendingMessageType(ContentType contentType)
 void Message::generateMessageID()
 {
 	// Get a unique ID
-	setMessageID(s_nextMessageID++);
+	setMessageID(reserveMessageIDs(1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MessageID Message::reserveMessageIDs(unsigned int count)
+{
+	boost::lock_guard<boost::mutex> lock(s_nextMessageIDMutex);
+
+	const uint32_t END_OF_MESSAGE_IDS = std::numeric_limits<MessageID>::max()
+		+ 1u;
+
+	if (count > END_OF_MESSAGE_IDS - MESSAGE_ID_FIRST)
+	{
+		Logging::error("Too many message IDs requested.");
+		return MESSAGE_ID_NONE;
+	}
+
+	// Start over rather than wrap into the special IDs once all are used up
+	// (e. g. by thousands of games simulated in a batch)
+	if (s_nextMessageID + count > END_OF_MESSAGE_IDS)
+		s_nextMessageID = MESSAGE_ID_FIRST;
+
+	MessageID firstMessageID = (MessageID)s_nextMessageID;
+
+	s_nextMessageID += count;
+
+	return firstMessageID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -242,6 +321,19 @@ void Message::setMessageID(MessageID messageID)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Message::setSentMessageID(MessageID messageID)
+{
+	boost::lock_guard<boost::mutex> lock(m_registeredMessageTypesMutex);
+
+	for (RegisteredMessageTypes::iterator i = m_registeredMessageTypes.begin();
+		i != m_registeredMessageTypes.end(); i++)
+	{
+		(*i).header.messageID = messageID;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 MessageID Message::messageID()
 {
 	return m_messageID;
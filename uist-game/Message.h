@@ -56,6 +56,19 @@ class Message
 		 */
 		void generateMessageID();
 
+		/**
+		 * @brief Reserves a range of unique message IDs.
+		 *
+		 * Reserves IDs for objects which are not messages themselves but are
+		 * sent via a shared message (e. g. game units via GameUnitMessage).
+		 *
+		 * @param count - The number of IDs to reserve.
+		 *
+		 * @return The first of the reserved, consecutive IDs, or
+		 *     MESSAGE_ID_NONE if there are fewer IDs than count.
+		 */
+		static MessageID reserveMessageIDs(unsigned int count);
+
 		/**
 		 * @brief Retrieve the message ID.
 		 *
@@ -157,6 +170,9 @@ class Message
 			/** @brief Pointer to the data which will be synchronized.*/
 			void *data;
 
+			/** @brief The size of the data, i. e. the maximal content length.*/
+			ContentLength capacity;
+
 			/** @brief The frequency with which the data will be sent.*/
 			UpdateFrequency updateFrequency;
 		};
@@ -179,6 +195,36 @@ class Message
 			void *data, ContentLength contentLength,
 			UpdateFrequency updateFrequency);
 
+		/**
+		 * @brief Sets how much of the registered data will be sent.
+		 *
+		 * Allows sending only the used beginning of variable-sized data (e. g.
+		 * a partially filled array). The length must not exceed the size the
+		 * message type was registered with.
+		 *
+		 * @param contentType - The data type of the message data.
+		 * @param contentLength - The number of bytes to send.
+		 */
+		void setContentLength(ContentType contentType,
+			ContentLength contentLength);
+
+		/**
+		 * @brief Copies received message data straight into a plain struct.
+		 *
+		 * Lets subclasses decode one-shot events (e. g. requests) without
+		 * constructing a message, which allocates its registered types.
+		 * Bytes not received are set to zero.
+		 *
+		 * @param messageData - The received message data.
+		 * @param contentType - The data type the struct holds.
+		 * @param data - The struct to fill.
+		 * @param capacity - The size of the struct.
+		 *
+		 * @return False if the message data has another type or is too long.
+		 */
+		static bool decode(MessageData &messageData, ContentType contentType,
+			void *data, ContentLength capacity);
+
 		/**
 		 * @brief Enables sending message data of a given type.
 		 *
@@ -208,6 +254,16 @@ class Message
 		 */
 		void setMessageID(MessageID messageID);
 
+		/**
+		 * @brief Sets the ID the message data will be sent with.
+		 *
+		 * In contrast to setMessageID, the message does not receive updates for
+		 * this ID. This allows one message to send data for many IDs.
+		 *
+		 * @param messageID - The ID to send the message data with.
+		 */
+		void setSentMessageID(MessageID messageID);
+
 		/** @brief The network interface to send and receive updates with. */
 		GameNetworkInterface *m_gameNetworkInterface;
 
@@ -221,8 +277,12 @@ class Message
 		/** @brief The message’s ID. */
 		MessageID m_messageID;
 
-		/** @brief The next free, unique message ID. */
-		static MessageID s_nextMessageID;
+		/** @brief The next free, unique message ID; wider than MessageID, so
+		 * that reaching the end of the IDs is not mistaken for a wrap. */
+		static uint32_t s_nextMessageID;
+
+		/** @brief Mutex allowing to create games on several threads. */
+		static boost::mutex s_nextMessageIDMutex;
 };
 
 #endif
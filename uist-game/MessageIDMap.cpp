@@ -0,0 +1,100 @@
+#include "MessageIDMap.h"
+
+// Smallest number of slots, a power of two like all sizes
+const unsigned int MINIMAL_SLOTS = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MessageIDMap
+//
+////////////////////////////////////////////////////////////////////////////////
+
+MessageIDMap::MessageIDMap()
+{
+	m_size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MessageIDMap::insert(MessageID messageID, int index)
+{
+	if (messageID == MESSAGE_ID_NONE)
+		return;
+
+	if (2 * (m_size + 1) > m_slots.size())
+		grow();
+
+	unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = messageID & mask;
+
+	while (m_slots[slot].messageID != MESSAGE_ID_NONE
+		   && m_slots[slot].messageID != messageID)
+		slot = (slot + 1) & mask;
+
+	if (m_slots[slot].messageID == MESSAGE_ID_NONE)
+		m_size++;
+
+	m_slots[slot].messageID = messageID;
+	m_slots[slot].index = index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int MessageIDMap::find(MessageID messageID) const
+{
+	if (m_slots.empty() || messageID == MESSAGE_ID_NONE)
+		return -1;
+
+	unsigned int mask = m_slots.size() - 1;
+
+	// Stops at the latest at a free slot, as at least half are free
+	for (unsigned int slot = messageID & mask;
+		 m_slots[slot].messageID != MESSAGE_ID_NONE; slot = (slot + 1) & mask)
+	{
+		if (m_slots[slot].messageID == messageID)
+			return m_slots[slot].index;
+	}
+
+	return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MessageIDMap::clear()
+{
+	Slot freeSlot;
+	freeSlot.messageID = MESSAGE_ID_NONE;
+	freeSlot.index = -1;
+
+	m_slots.assign(m_slots.size(), freeSlot);
+	m_size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int MessageIDMap::size() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MessageIDMap::grow()
+{
+	std::vector<Slot> oldSlots;
+	oldSlots.swap(m_slots);
+
+	Slot freeSlot;
+	freeSlot.messageID = MESSAGE_ID_NONE;
+	freeSlot.index = -1;
+
+	m_slots.assign(oldSlots.empty() ? MINIMAL_SLOTS : 2 * oldSlots.size(),
+		freeSlot);
+	m_size = 0;
+
+	for (unsigned int i = 0; i < oldSlots.size(); i++)
+	{
+		if (oldSlots[i].messageID != MESSAGE_ID_NONE)
+			insert(oldSlots[i].messageID, oldSlots[i].index);
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef __GAME_MESSAGEIDMAP_H
+#define __GAME_MESSAGEIDMAP_H
+
+#include <vector>
+
+#include "MessageData.h"
+
+/**
+ * @class MessageIDMap
+ *
+ * @brief Hash table from message IDs to indices, e. g. of units.
+ *
+ * Open addressing with linear probing in one flat array, which is kept at
+ * most half full. Message IDs are handed out consecutively, so the ID itself
+ * is used as the hash: a level's units and obstacles fill neighboring slots
+ * without collisions. Entries are only removed all at once.
+ */
+class MessageIDMap
+{
+	public:
+		MessageIDMap();
+
+		/**
+		 * @brief Maps a message ID to an index, replacing a previous one.
+		 *
+		 * @param messageID - Any ID but MESSAGE_ID_NONE, which marks free
+		 *     slots.
+		 * @param index - The index to look up for the ID.
+		 */
+		void insert(MessageID messageID, int index);
+
+		/**
+		 * @brief Looks up the index of a message ID.
+		 *
+		 * @return The index, or -1 if the ID is unknown.
+		 */
+		int find(MessageID messageID) const;
+
+		/** @brief Removes all entries, keeping the allocated slots. */
+		void clear();
+
+		unsigned int size() const;
+
+	protected:
+		struct Slot
+		{
+			MessageID messageID;
+			int index;
+		};
+
+		void grow();
+
+		std::vector<Slot> m_slots;
+		unsigned int m_size;
+};
+
+#endif
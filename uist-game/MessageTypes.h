@@ -14,7 +14,9 @@ enum
 	MESSAGE_HIGHLIGHT_REQUEST,
 	MESSAGE_GAME_OBSTACLE,
 
-	MESSAGE_NEW_PLAYER_ID
+	MESSAGE_NEW_PLAYER_ID,
+	MESSAGE_PING,
+	MESSAGE_INPUT_BATCH
 };
 
 #endif
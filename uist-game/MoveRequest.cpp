@@ -64,3 +64,11 @@ float MoveRequest::strength()
 {
 	return m_networkData.strength;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MoveRequest::decode(MessageData &messageData, NetworkData &networkData)
+{
+	return Message::decode(messageData, MESSAGE_MOVE_REQUEST, &networkData,
+		sizeof(NetworkData));
+}
@@ -7,6 +7,21 @@
 class MoveRequest : public Message
 {
 	public:
+		/** @brief Content of the message. */
+		struct NetworkData
+		{
+			uint8_t unitIndex;
+			float angle;
+			float strength;
+		};
+
+		/**
+		 * @brief Reads a received request without constructing a message.
+		 *
+		 * @return False if the message data is no valid request.
+		 */
+		static bool decode(MessageData &messageData, NetworkData &networkData);
+
 		MoveRequest(GameNetworkInterface *gameNetworkInterface);
 
 		void setUnitIndex(uint8_t unitIndex);
@@ -19,13 +34,6 @@ class MoveRequest : public Message
 		float strength();
 
 	protected:
-		struct NetworkData
-		{
-			uint8_t unitIndex;
-			float angle;
-			float strength;
-		};
-
 		NetworkData m_networkData;
 };
 
@@ -5,6 +5,10 @@
 
 #include "Message.h"
 #include "Logging.h"
+#include "Profiling.h"
+
+// Messages queued before the queue grows, e. g. one frame's input batches
+const unsigned int INITIAL_WRITE_QUEUE_CAPACITY = 16;
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -13,7 +17,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 NetworkClient::NetworkClient()
+	: m_writeMessageQueue(INITIAL_WRITE_QUEUE_CAPACITY)
 {
+	m_isWriting = false;
+
 	boost::lock_guard<boost::mutex> lock(m_isConnectedMutex);
 	m_isConnected = false;
 }
@@ -23,6 +30,7 @@ NetworkClient::NetworkClient()
 void NetworkClient::run()
 {
 	Logging::info("Network client thread is running.");
+	PROFILE_THREAD("network client");
 
 	while (true)
 	{
@@ -225,7 +233,10 @@ void NetworkClient::handleReadBody(const boost::system::error_code &error)
 	// Read the message's content
 	m_currentMessage.copyContentFrom(m_readBuffer);
 
-	onMessageReceived(m_currentMessage);
+	{
+		PROFILE_SCOPE("network receive (client)");
+		onMessageReceived(m_currentMessage);
+	}
 
 	// Wait for next incoming message and read its header
 	boost::asio::async_read(
@@ -276,28 +287,23 @@ void NetworkClient::reconnectToServer()
 
 void NetworkClient::deliver(MessageData messageData)
 {
+	PROFILE_SCOPE("network send (client)");
+
 	boost::lock_guard<boost::mutex> writeMessageQueueLock(m_writeMessageQueueMutex);
 
-	bool isWriteInProgress = !m_writeMessageQueue.empty();
+	if (m_writeMessageQueue.full())
+		m_writeMessageQueue.set_capacity(2 * m_writeMessageQueue.capacity());
 
 	// Insert requested message into sending queue
 	m_writeMessageQueue.push_back(messageData);
 
-	// Wait for the queue to be empty before sending
+	// Wait for the current message to be sent before sending
 	boost::lock_guard<boost::mutex> isConnectedLock(m_isConnectedMutex);
 
-	if (!m_isConnected || isWriteInProgress)
+	if (!m_isConnected || m_isWriting)
 		return;
 
-	int dataLength = m_currentMessage.headerLength()
-		+ m_writeMessageQueue.front().contentLength();
-
-	// Write message via network eventually
-	boost::asio::async_write(
-		*m_socket,
-		boost::asio::buffer(&m_writeMessageQueue.front(), dataLength),
-		boost::bind(&NetworkClient::handleWrite, this,
-			boost::asio::placeholders::error));
+	writeNextMessage();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -315,19 +321,29 @@ void NetworkClient::handleWrite(const boost::system::error_code &error)
 
 	boost::lock_guard<boost::mutex> lock(m_writeMessageQueueMutex);
 
-	// If last message has been sent, remove it from the queue's beginning
+	m_isWriting = false;
+
+	// Send next messages if there are remaining ones in the queue
+	if (!m_writeMessageQueue.empty())
+		writeNextMessage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NetworkClient::writeNextMessage()
+{
+	m_writeMessage = m_writeMessageQueue.front();
 	m_writeMessageQueue.pop_front();
 
-	if (m_writeMessageQueue.empty())
-		return;
+	m_isWriting = true;
 
-	int dataLength = m_currentMessage.headerLength()
-		+ m_writeMessageQueue.front().contentLength();
+	int dataLength = m_writeMessage.headerLength()
+		+ m_writeMessage.contentLength();
 
-	// Send next messages if there are remaining ones in the queue
+	// Write message via network eventually
 	boost::asio::async_write(
 		*m_socket,
-		boost::asio::buffer(&m_writeMessageQueue.front(), dataLength),
+		boost::asio::buffer(&m_writeMessage, dataLength),
 		boost::bind(&NetworkClient::handleWrite, this,
 			boost::asio::placeholders::error));
 }
@@ -2,12 +2,11 @@
 #define __NETWORK_NETWORKCLIENT_H
 
 #include <boost/asio.hpp>
+#include <boost/circular_buffer.hpp>
 #include <boost/signals.hpp>
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
 
-#include <deque>
-
 #include "MessageData.h"
 
 // Forward declarations
@@ -195,6 +194,13 @@ class NetworkClient
 		 */
 		void handleWrite(const boost::system::error_code &error);
 
+		/**
+		 * @brief Starts transmitting the first queued message.
+		 *
+		 * Must be called with the queue locked.
+		 */
+		void writeNextMessage();
+
 		/** @brief Network service. */
 		boost::shared_ptr<boost::asio::io_service> m_ioService;
 
@@ -210,8 +216,19 @@ class NetworkClient
 		/** @brief Currently incoming, partly composed message. */
 		MessageData m_currentMessage;
 
-		/** @brief Queue of outgoing messages. */
-		std::deque<MessageData> m_writeMessageQueue;
+		/**
+		 * @brief Queue of outgoing messages.
+		 *
+		 * Grows when full but never shrinks, so queueing a message does not
+		 * allocate once the queue has reached its working size.
+		 */
+		boost::circular_buffer<MessageData> m_writeMessageQueue;
+
+		/** @brief The message being transmitted, kept out of the queue,
+		 * which moves its messages when growing. */
+		MessageData m_writeMessage;
+
+		bool m_isWriting;
 
 		/** @brief Mutex ensuring thread-safety of the message queue. */
 		boost::mutex m_writeMessageQueueMutex;
@@ -3,6 +3,7 @@
 #include <boost/bind.hpp>
 
 #include "Logging.h"
+#include "Profiling.h"
 #include "NetworkServerSession.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +22,7 @@ NetworkServer::NetworkServer()
 void NetworkServer::run()
 {
 	Logging::info("Network server thread is running.");
+	PROFILE_THREAD("network server");
 
 	try
 	{
@@ -3,6 +3,10 @@
 #include <boost/thread/lock_guard.hpp>
 
 #include "Logging.h"
+#include "Profiling.h"
+
+// Messages queued before the queue grows, e. g. the units of a small level
+const unsigned int INITIAL_WRITE_QUEUE_CAPACITY = 64;
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -11,8 +15,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 NetworkServerSession::NetworkServerSession(boost::asio::io_service &ioService)
-	: m_socket(ioService)
+	: m_socket(ioService),
+	  m_writeMessageQueue(INITIAL_WRITE_QUEUE_CAPACITY)
 {
+	m_isWriting = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,7 +84,10 @@ void NetworkServerSession::handleReadBody(const boost::system::error_code &error
 	// Read the message's content
 	m_currentMessage.copyContentFrom(m_readBuffer);
 
-	onMessageReceived(m_currentMessage);
+	{
+		PROFILE_SCOPE("network receive (server)");
+		onMessageReceived(m_currentMessage);
+	}
 
 	// Wait for next incoming message and read its header
 	boost::asio::async_read(
@@ -99,26 +108,19 @@ void NetworkServerSession::send(MessageData messageData)
 
 void NetworkServerSession::deliver(MessageData messageData)
 {
+	PROFILE_SCOPE("network send (server)");
+
 	boost::lock_guard<boost::mutex> lock(m_writeMessageQueueMutex);
 
-	bool isWriteInProgress = !m_writeMessageQueue.empty();
+	if (m_writeMessageQueue.full())
+		m_writeMessageQueue.set_capacity(2 * m_writeMessageQueue.capacity());
 
 	// Insert requested message into sending queue
 	m_writeMessageQueue.push_back(messageData);
 
-	// Wait for the queue to be empty before sending
-	if (isWriteInProgress)
-		return;
-
-	int dataLength = m_currentMessage.headerLength()
-		+ m_writeMessageQueue.front().contentLength();
-
-	// Write message via network eventually
-	boost::asio::async_write(
-		m_socket,
-		boost::asio::buffer(&m_writeMessageQueue.front(), dataLength),
-		boost::bind(&NetworkServerSession::handleWrite, this,
-			boost::asio::placeholders::error));
+	// Wait for the current message to be sent before sending
+	if (!m_isWriting)
+		writeNextMessage();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -137,19 +139,29 @@ void NetworkServerSession::handleWrite(const boost::system::error_code &error)
 
 	boost::lock_guard<boost::mutex> lock(m_writeMessageQueueMutex);
 
-	// If last message has been sent, remove it from the queue's beginning
+	m_isWriting = false;
+
+	// Send next messages if there are remaining ones in the queue
+	if (!m_writeMessageQueue.empty())
+		writeNextMessage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NetworkServerSession::writeNextMessage()
+{
+	m_writeMessage = m_writeMessageQueue.front();
 	m_writeMessageQueue.pop_front();
 
-	if (m_writeMessageQueue.empty())
-		return;
+	m_isWriting = true;
 
-	int dataLength = m_currentMessage.headerLength()
-		+ m_writeMessageQueue.front().contentLength();
+	int dataLength = m_writeMessage.headerLength()
+		+ m_writeMessage.contentLength();
 
-	// Send next messages if there are remaining ones in the queue
+	// Write message via network eventually
 	boost::asio::async_write(
 		m_socket,
-		boost::asio::buffer(&m_writeMessageQueue.front(), dataLength),
+		boost::asio::buffer(&m_writeMessage, dataLength),
 		boost::bind(&NetworkServerSession::handleWrite, this,
 			boost::asio::placeholders::error));
 }
@@ -3,11 +3,10 @@
 
 #include <boost/bind.hpp>
 #include <boost/asio.hpp>
+#include <boost/circular_buffer.hpp>
 #include <boost/signal.hpp>
 #include <boost/thread/mutex.hpp>
 
-#include <deque>
-
 #include "MessageData.h"
 
 /**
@@ -103,6 +102,13 @@ class NetworkServerSession
 		 */
 		void handleWrite(const boost::system::error_code &error);
 
+		/**
+		 * @brief Starts writing the first queued message.
+		 *
+		 * Must be called with the queue locked.
+		 */
+		void writeNextMessage();
+
 		/** @brief The socket to send and receive messages with. */
 		boost::asio::ip::tcp::socket m_socket;
 
@@ -112,8 +118,19 @@ class NetworkServerSession
 		/** @brief Holds the aggregated incoming data. */
 		MessageData m_currentMessage;
 
-		/** @brief List of all messages that will be sent soon. */
-		std::deque<MessageData> m_writeMessageQueue;
+		/**
+		 * @brief List of all messages that will be sent soon.
+		 *
+		 * Grows when full but never shrinks, so queueing a message does not
+		 * allocate once the queue has reached its working size.
+		 */
+		boost::circular_buffer<MessageData> m_writeMessageQueue;
+
+		/** @brief The message being written, kept out of the queue, which
+		 * moves its messages when growing. */
+		MessageData m_writeMessage;
+
+		bool m_isWriting;
 
 		/** @brief Mutex ensuring thread-safety of message delivery. */
 		boost::mutex m_writeMessageQueueMutex;
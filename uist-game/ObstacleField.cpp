@@ -0,0 +1,151 @@
+#include "ObstacleField.h"
+
+#include <algorithm>
+#include <cmath>
+
+float ObstacleField::s_resolution = 2.0f;
+float ObstacleField::s_maximalDistance = 32.0f;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ObstacleField
+//
+////////////////////////////////////////////////////////////////////////////////
+
+ObstacleField::ObstacleField()
+{
+	reset(0.0f, 0.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ObstacleField::reset(float width, float height)
+{
+	// One more sample than cells, so that the far border is covered as well
+	m_columns = std::max(2, (int)ceil(width / s_resolution) + 1);
+	m_rows = std::max(2, (int)ceil(height / s_resolution) + 1);
+
+	m_samples.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ObstacleField::addObstacle(float x, float y, float radius)
+{
+	if (m_samples.empty())
+	{
+		Sample farSample;
+		farSample.distance = s_maximalDistance;
+		farSample.normalX = 0.0f;
+		farSample.normalY = 0.0f;
+
+		m_samples.assign(m_columns * m_rows, farSample);
+	}
+
+	// Only samples within the maximal distance of the border can change
+	float reach = radius + s_maximalDistance;
+
+	int firstColumn = std::max(0, (int)floor((x - reach) / s_resolution));
+	int lastColumn = std::min(m_columns - 1, (int)ceil((x + reach) / s_resolution));
+	int firstRow = std::max(0, (int)floor((y - reach) / s_resolution));
+	int lastRow = std::min(m_rows - 1, (int)ceil((y + reach) / s_resolution));
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			float directionX = column * s_resolution - x;
+			float directionY = row * s_resolution - y;
+			float centerDistance = sqrt(directionX * directionX
+				+ directionY * directionY);
+
+			float distance = centerDistance - radius;
+
+			Sample &sample = m_samples[row * m_columns + column];
+
+			if (distance >= sample.distance)
+				continue;
+
+			sample.distance = distance;
+
+			// The direction is undefined right at the center
+			if (centerDistance > 0.0f)
+			{
+				sample.normalX = directionX / centerDistance;
+				sample.normalY = directionY / centerDistance;
+			}
+			else
+			{
+				sample.normalX = 0.0f;
+				sample.normalY = 0.0f;
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ObstacleField::isEmpty() const
+{
+	return m_samples.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+float ObstacleField::distance(float x, float y, float &normalX,
+	float &normalY) const
+{
+	normalX = 0.0f;
+	normalY = 0.0f;
+
+	if (m_samples.empty())
+		return s_maximalDistance;
+
+	float column = std::min(std::max(x / s_resolution, 0.0f),
+		(float)(m_columns - 1));
+	float row = std::min(std::max(y / s_resolution, 0.0f),
+		(float)(m_rows - 1));
+
+	int left = std::min((int)column, m_columns - 2);
+	int top = std::min((int)row, m_rows - 2);
+
+	float weightX = column - left;
+	float weightY = row - top;
+
+	const Sample &topLeft = m_samples[top * m_columns + left];
+	const Sample &topRight = m_samples[top * m_columns + left + 1];
+	const Sample &bottomLeft = m_samples[(top + 1) * m_columns + left];
+	const Sample &bottomRight = m_samples[(top + 1) * m_columns + left + 1];
+
+	float weightTopLeft = (1.0f - weightX) * (1.0f - weightY);
+	float weightTopRight = weightX * (1.0f - weightY);
+	float weightBottomLeft = (1.0f - weightX) * weightY;
+	float weightBottomRight = weightX * weightY;
+
+	float distance = weightTopLeft * topLeft.distance
+		+ weightTopRight * topRight.distance
+		+ weightBottomLeft * bottomLeft.distance
+		+ weightBottomRight * bottomRight.distance;
+
+	float interpolatedX = weightTopLeft * topLeft.normalX
+		+ weightTopRight * topRight.normalX
+		+ weightBottomLeft * bottomLeft.normalX
+		+ weightBottomRight * bottomRight.normalX;
+
+	float interpolatedY = weightTopLeft * topLeft.normalY
+		+ weightTopRight * topRight.normalY
+		+ weightBottomLeft * bottomLeft.normalY
+		+ weightBottomRight * bottomRight.normalY;
+
+	// Normals of different obstacles can cancel out between them
+	float length = sqrt(interpolatedX * interpolatedX
+		+ interpolatedY * interpolatedY);
+
+	if (length > 0.0f)
+	{
+		normalX = interpolatedX / length;
+		normalY = interpolatedY / length;
+	}
+
+	return distance;
+}
@@ -0,0 +1,80 @@
+#ifndef __GAME_OBSTACLEFIELD_H
+#define __GAME_OBSTACLEFIELD_H
+
+#include <vector>
+
+/**
+ * @class ObstacleField
+ *
+ * @brief Signed distance to the obstacles of a level, sampled on a grid.
+ *
+ * The field is baked once when the level is loaded. Afterwards, the distance
+ * to the closest obstacle and the direction away from it are one bilinear
+ * lookup, independent of the number of obstacles.
+ */
+class ObstacleField
+{
+	public:
+		/** @brief Distance between two samples in field units. */
+		static float s_resolution;
+
+		/**
+		 * @brief Larger distances are not stored.
+		 *
+		 * Needs to exceed the radius of the units colliding with the field.
+		 */
+		static float s_maximalDistance;
+
+	public:
+		ObstacleField();
+
+		/**
+		 * @brief Removes all obstacles.
+		 *
+		 * @param width - Width of the covered area.
+		 * @param height - Height of the covered area.
+		 */
+		void reset(float width, float height);
+
+		/**
+		 * @brief Adds a circular obstacle to the field.
+		 *
+		 * Only the samples within s_maximalDistance of the obstacle are
+		 * touched, so the cost depends on the size of the obstacle and not on
+		 * the number of obstacles added before.
+		 */
+		void addObstacle(float x, float y, float radius);
+
+		bool isEmpty() const;
+
+		/**
+		 * @brief Looks up the distance to the closest obstacle border.
+		 *
+		 * Positions outside of the area use the closest border sample.
+		 *
+		 * @param x - X coordinate of the position.
+		 * @param y - Y coordinate of the position.
+		 * @param normalX - Receives the x component of the direction away from
+		 *     the closest obstacle.
+		 * @param normalY - Receives the y component of that direction.
+		 *
+		 * @return The distance, negative inside of an obstacle and at most
+		 *     s_maximalDistance.
+		 */
+		float distance(float x, float y, float &normalX, float &normalY) const;
+
+	protected:
+		struct Sample
+		{
+			float distance;
+			float normalX;
+			float normalY;
+		};
+
+		int m_columns;
+		int m_rows;
+
+		std::vector<Sample> m_samples;
+};
+
+#endif
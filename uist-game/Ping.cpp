@@ -0,0 +1,52 @@
+#include "Ping.h"
+
+#include <boost/bind.hpp>
+
+#include "MessageTypes.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Ping
+//
+////////////////////////////////////////////////////////////////////////////////
+
+Ping::Ping(GameNetworkInterface *gameNetworkInterface)
+	: Message(gameNetworkInterface)
+{
+	m_networkData.sequenceNumber = 0;
+	m_networkData.sendTime = 0;
+
+	// Set up for network transmission via messages
+	registerMessageType(MESSAGE_PING, &m_networkData,
+		sizeof(NetworkData), UPDATE_FREQUENCY_ONCE);
+
+	setMessageID(MESSAGE_ID_EVENT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Ping::setSequenceNumber(uint32_t sequenceNumber)
+{
+	m_networkData.sequenceNumber = sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Ping::sequenceNumber()
+{
+	return m_networkData.sequenceNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Ping::setSendTime(uint64_t sendTime)
+{
+	m_networkData.sendTime = sendTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Ping::sendTime()
+{
+	return m_networkData.sendTime;
+}
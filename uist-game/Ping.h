@@ -0,0 +1,30 @@
+#ifndef __GAME_PING_H
+#define __GAME_PING_H
+
+#include "Message.h"
+#include "ForwardDeclarations.h"
+
+class Ping : public Message
+{
+	public:
+		Ping(GameNetworkInterface *gameNetworkInterface);
+
+		void setSequenceNumber(uint32_t sequenceNumber);
+		uint32_t sequenceNumber();
+
+		void setSendTime(uint64_t sendTime);
+		uint64_t sendTime();
+
+	protected:
+		struct NetworkData
+		{
+			uint32_t sequenceNumber;
+
+			// Microseconds of the sender's Clock, echoed back unchanged
+			uint64_t sendTime;
+		};
+
+		NetworkData m_networkData;
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "Profiling.h"
+
+#include "Clock.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <cstring>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/tss.hpp>
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Profiling
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Profiling::Buffer*> Profiling::s_buffers;
+boost::mutex Profiling::s_buffersMutex;
+
+// Buffers outlive their threads so they can still be exported, hence no cleanup
+static void keepBuffer(void *)
+{
+}
+
+static boost::thread_specific_ptr<void> s_threadBuffer(keepBuffer);
+
+////////////////////////////////////////////////////////////////////////////////
+
+Profiling::Buffer::Buffer()
+	: writeCount(0), threadName(NULL), threadNumber(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Profiling::now()
+{
+	return Clock::microseconds();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Profiling::Buffer *Profiling::threadBuffer()
+{
+	Buffer *buffer = static_cast<Buffer*>(s_threadBuffer.get());
+
+	if (buffer)
+		return buffer;
+
+	// First event of this thread, register a new buffer
+	buffer = new Buffer;
+
+	boost::lock_guard<boost::mutex> lock(s_buffersMutex);
+	buffer->threadNumber = (int)s_buffers.size() + 1;
+	s_buffers.push_back(buffer);
+	s_threadBuffer.reset(buffer);
+
+	return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Profiling::record(const char *name, uint64_t start, uint32_t duration)
+{
+	Buffer *buffer = threadBuffer();
+
+	// Only this thread writes, readers check the count to detect overwrites
+	uint32_t count = buffer->writeCount.load(boost::memory_order_relaxed);
+
+	Event &event = buffer->events[count % s_bufferSize];
+	event.name = name;
+	event.start = start;
+	event.duration = duration;
+
+	buffer->writeCount.store(count + 1, boost::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Profiling::setThreadName(const char *name)
+{
+	threadBuffer()->threadName = name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Profiling::averageDuration(const char *name, unsigned int maximalEvents)
+{
+	Buffer *buffer = threadBuffer();
+
+	uint32_t end = buffer->writeCount.load(boost::memory_order_relaxed);
+	uint32_t searchLength = std::min(end, std::min(s_bufferSize, 512u));
+
+	uint64_t totalDuration = 0;
+	unsigned int matchingEvents = 0;
+
+	// Walk backwards through the most recent events of this thread
+	for (uint32_t i = 1; i <= searchLength && matchingEvents < maximalEvents; i++)
+	{
+		const Event &event = buffer->events[(end - i) % s_bufferSize];
+
+		if (event.name != name && strcmp(event.name, name))
+			continue;
+
+		totalDuration += event.duration;
+		matchingEvents++;
+	}
+
+	if (!matchingEvents)
+		return -1.0;
+
+	return totalDuration / 1000.0 / matchingEvents;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Profiling::exportChromeTrace(const std::string &fileName)
+{
+	std::ofstream file(fileName.c_str());
+
+	if (!file)
+		return false;
+
+	boost::lock_guard<boost::mutex> lock(s_buffersMutex);
+
+	file << "{\"traceEvents\":[";
+
+	bool isFirstEvent = true;
+
+	for (unsigned int i = 0; i < s_buffers.size(); i++)
+	{
+		Buffer *buffer = s_buffers[i];
+
+		if (buffer->threadName)
+		{
+			file << (isFirstEvent ? "" : ",") << std::endl
+				<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+				<< buffer->threadNumber << ",\"args\":{\"name\":\""
+				<< buffer->threadName << "\"}}";
+			isFirstEvent = false;
+		}
+
+		// Copy a consistent window while the owning thread keeps writing
+		uint32_t end = buffer->writeCount.load(boost::memory_order_acquire);
+		uint32_t begin = end > s_bufferSize ? end - s_bufferSize : 0;
+
+		std::vector<Event> events;
+		events.reserve(end - begin);
+
+		for (uint32_t j = begin; j < end; j++)
+			events.push_back(buffer->events[j % s_bufferSize]);
+
+		// Drop the events which might have been overwritten in the meantime,
+		// including the slot which might be being written right now
+		uint32_t endAfterCopy = buffer->writeCount.load(boost::memory_order_acquire) + 1;
+		uint32_t firstValid = endAfterCopy > s_bufferSize
+			? endAfterCopy - s_bufferSize : 0;
+
+		for (uint32_t j = std::max(begin, firstValid); j < end; j++)
+		{
+			const Event &event = events[j - begin];
+
+			file << (isFirstEvent ? "" : ",") << std::endl
+				<< "{\"name\":\"" << event.name
+				<< "\",\"cat\":\"uist\",\"ph\":\"X\",\"ts\":" << event.start
+				<< ",\"dur\":" << event.duration
+				<< ",\"pid\":1,\"tid\":" << buffer->threadNumber << "}";
+			isFirstEvent = false;
+		}
+	}
+
+	file << std::endl << "]}" << std::endl;
+
+	return (bool)file;
+}
@@ -0,0 +1,150 @@
+#ifndef __GENERAL_PROFILING_H
+#define __GENERAL_PROFILING_H
+
+#include <string>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * @brief Measures the enclosing scope and records it as a trace event.
+ *
+ * Only active if compiled with UIST_PROFILING (see "make profile"), expands to
+ * nothing otherwise. The name must be a string literal.
+ */
+#ifdef UIST_PROFILING
+#define PROFILE_SCOPE(name) \
+	ProfilingScope PROFILE_CONCATENATE(profilingScope, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiling::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#endif
+
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_EXPANDED(a, b)
+#define PROFILE_CONCATENATE_EXPANDED(a, b) a##b
+
+/**
+ * @class Profiling
+ *
+ * @brief Collects timing events of all threads.
+ *
+ * Each thread writes its events into its own fixed-size ring buffer without
+ * any locking, so recording costs two clock reads and a few stores. The
+ * buffers can be exported at any time as Chrome trace JSON (load it in
+ * chrome://tracing or ui.perfetto.dev).
+ */
+class Profiling
+{
+	public:
+		/** @brief Number of events kept per thread. */
+		static const unsigned int s_bufferSize = 16384;
+
+		/**
+		 * @brief Returns a monotonic timestamp.
+		 *
+		 * @return Microseconds since an arbitrary, fixed point in time.
+		 */
+		static uint64_t now();
+
+		/**
+		 * @brief Records an event in the calling thread’s buffer.
+		 *
+		 * @param name - Static name of the event.
+		 * @param start - Start of the event as returned by now().
+		 * @param duration - Duration of the event in microseconds.
+		 */
+		static void record(const char *name, uint64_t start, uint32_t duration);
+
+		/**
+		 * @brief Names the calling thread in exported traces.
+		 *
+		 * @param name - Static name of the thread.
+		 */
+		static void setThreadName(const char *name);
+
+		/**
+		 * @brief Averages the latest events of the calling thread.
+		 *
+		 * Only looks at the calling thread’s most recent events, so call it
+		 * from the thread that records them.
+		 *
+		 * @param name - Name of the events to average.
+		 * @param maximalEvents - How many of the latest matching events to use.
+		 *
+		 * @return Average duration in milliseconds, or -1 if there is none.
+		 */
+		static double averageDuration(const char *name,
+			unsigned int maximalEvents = 16);
+
+		/**
+		 * @brief Writes all buffered events as Chrome trace JSON.
+		 *
+		 * @param fileName - The file to write the trace to.
+		 *
+		 * @return Whether the file could be written.
+		 */
+		static bool exportChromeTrace(const std::string &fileName);
+
+	protected:
+		struct Event
+		{
+			const char *name;
+			uint64_t start;
+			uint32_t duration;
+		};
+
+		/**
+		 * @struct Buffer
+		 *
+		 * @brief Ring buffer written by exactly one thread.
+		 */
+		struct Buffer
+		{
+			Buffer();
+
+			Event events[s_bufferSize];
+
+			/** @brief Total number of events written so far. */
+			boost::atomic<uint32_t> writeCount;
+
+			const char *threadName;
+			int threadNumber;
+		};
+
+		static Buffer *threadBuffer();
+
+		/** @brief All buffers ever created, they are never freed. */
+		static std::vector<Buffer*> s_buffers;
+
+		/** @brief Mutex guarding the buffer list (not the buffers). */
+		static boost::mutex s_buffersMutex;
+};
+
+/**
+ * @class ProfilingScope
+ *
+ * @brief Records the lifetime of the object as one event.
+ */
+class ProfilingScope
+{
+	public:
+		ProfilingScope(const char *name)
+			: m_name(name), m_start(Profiling::now())
+		{
+		}
+
+		~ProfilingScope()
+		{
+			Profiling::record(m_name, m_start,
+				(uint32_t)(Profiling::now() - m_start));
+		}
+
+	private:
+		const char *m_name;
+		uint64_t m_start;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "SnapshotBuffer.h"
+
+#include <algorithm>
+
+#include "Clock.h"
+
+double SnapshotBuffer::s_delay = 0.06;
+double SnapshotBuffer::s_maximalExtrapolation = 0.2;
+
+// Weight of a new snapshot in the estimated clock offset
+const double CLOCK_OFFSET_SMOOTHING = 0.05;
+
+// Snapshots this many seconds older than the newest one belong to a new game
+const double SERVER_RESTART_TIME = 1.0;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SnapshotBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SnapshotBuffer::History::History()
+{
+	newest = 0;
+	count = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SnapshotBuffer::SnapshotBuffer()
+{
+	clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SnapshotBuffer::clear()
+{
+	m_histories.clear();
+
+	m_newestTime = 0.0;
+	m_clockOffset = 0.0;
+	m_hasClockOffset = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SnapshotBuffer::add(unsigned int index, double time, float x, float y,
+	float vx, float vy)
+{
+	// Time running backwards means the server has started over
+	if (m_hasClockOffset && time < m_newestTime - SERVER_RESTART_TIME)
+		clear();
+
+	// All units of a tick carry the same time, so the clock is only adjusted
+	// once per tick
+	if (!m_hasClockOffset || time > m_newestTime)
+	{
+		double offset = time - Clock::seconds();
+
+		if (!m_hasClockOffset)
+			m_clockOffset = offset;
+		else
+			m_clockOffset += CLOCK_OFFSET_SMOOTHING * (offset - m_clockOffset);
+
+		m_hasClockOffset = true;
+		m_newestTime = time;
+	}
+
+	if (index >= m_histories.size())
+		m_histories.resize(index + 1);
+
+	History &history = m_histories[index];
+
+	// Repeated states (e. g. while the game has not started) replace the last
+	// one, older ones are useless
+	if (history.count > 0)
+	{
+		double newestTime = history.snapshots[history.newest].time;
+
+		if (time < newestTime)
+			return;
+
+		if (time > newestTime)
+		{
+			history.newest = (history.newest + 1) % s_capacity;
+			history.count = std::min(history.count + 1, s_capacity);
+		}
+	}
+	else
+	{
+		history.count = 1;
+	}
+
+	Snapshot &snapshot = history.snapshots[history.newest];
+	snapshot.time = time;
+	snapshot.x = x;
+	snapshot.y = y;
+	snapshot.vx = vx;
+	snapshot.vy = vy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double SnapshotBuffer::presentationTime() const
+{
+	return Clock::seconds() + m_clockOffset - s_delay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SnapshotBuffer::sample(double time, std::vector<float> &x,
+	std::vector<float> &y) const
+{
+	unsigned int numberOfUnits = std::min((unsigned int)m_histories.size(),
+		(unsigned int)std::min(x.size(), y.size()));
+
+	for (unsigned int i = 0; i < numberOfUnits; i++)
+	{
+		const History &history = m_histories[i];
+
+		if (history.count == 0)
+			continue;
+
+		const Snapshot &newest = snapshot(history, 0);
+
+		// Packet gap: continue the last movement for a while
+		if (time >= newest.time)
+		{
+			float extrapolation = (float)std::min(time - newest.time,
+				s_maximalExtrapolation);
+
+			x[i] = newest.x + newest.vx * extrapolation;
+			y[i] = newest.y + newest.vy * extrapolation;
+
+			continue;
+		}
+
+		// Find the two snapshots around the time
+		const Snapshot *later = &newest;
+		const Snapshot *earlier = &newest;
+
+		for (unsigned int age = 1; age < history.count; age++)
+		{
+			earlier = &snapshot(history, age);
+
+			if (earlier->time <= time)
+				break;
+
+			later = earlier;
+		}
+
+		if (earlier->time > time || earlier == later)
+		{
+			// Older than all snapshots
+			x[i] = earlier->x;
+			y[i] = earlier->y;
+
+			continue;
+		}
+
+		float alpha = (float)((time - earlier->time)
+			/ (later->time - earlier->time));
+
+		x[i] = earlier->x + (later->x - earlier->x) * alpha;
+		y[i] = earlier->y + (later->y - earlier->y) * alpha;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const SnapshotBuffer::Snapshot &SnapshotBuffer::snapshot(
+	const History &history, unsigned int age) const
+{
+	return history.snapshots[(history.newest + s_capacity - age) % s_capacity];
+}
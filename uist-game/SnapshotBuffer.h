@@ -0,0 +1,96 @@
+#ifndef __GAME_SNAPSHOTBUFFER_H
+#define __GAME_SNAPSHOTBUFFER_H
+
+#include <vector>
+
+/**
+ * @class SnapshotBuffer
+ *
+ * @brief Recent server states of the units, for smooth presentation.
+ *
+ * The server sends the units once per tick, stamped with its simulation time.
+ * Instead of drawing the latest state, the client draws the units as they
+ * were s_delay seconds ago, interpolated between the two snapshots around
+ * that time. The delay hides the tick rate and the network jitter. If no
+ * newer snapshot has arrived (e. g. after a lost or late packet), the units
+ * are extrapolated along their last velocity for a short while.
+ */
+class SnapshotBuffer
+{
+	public:
+		/** @brief How far the presented state lags behind, in seconds. */
+		static double s_delay;
+
+		/** @brief Longest extrapolation beyond the newest snapshot. */
+		static double s_maximalExtrapolation;
+
+		/** @brief Snapshots kept per unit. */
+		static const unsigned int s_capacity = 8;
+
+	public:
+		SnapshotBuffer();
+
+		void clear();
+
+		/**
+		 * @brief Stores a received state of one unit.
+		 *
+		 * @param index - Index of the unit.
+		 * @param time - Server simulation time of the state in seconds.
+		 */
+		void add(unsigned int index, double time, float x, float y, float vx,
+			float vy);
+
+		/**
+		 * @brief Returns the server time to present now.
+		 *
+		 * The time advances with the local clock, lagging s_delay behind the
+		 * estimated current server time.
+		 */
+		double presentationTime() const;
+
+		/**
+		 * @brief Computes the positions of all units at a server time.
+		 *
+		 * @param time - The server time, usually presentationTime().
+		 * @param x - Receives the x coordinates, entries of units without
+		 *     snapshots are kept.
+		 * @param y - Receives the y coordinates.
+		 */
+		void sample(double time, std::vector<float> &x,
+			std::vector<float> &y) const;
+
+	protected:
+		struct Snapshot
+		{
+			double time;
+
+			float x;
+			float y;
+			float vx;
+			float vy;
+		};
+
+		struct History
+		{
+			History();
+
+			Snapshot snapshots[s_capacity];
+
+			unsigned int newest;
+			unsigned int count;
+		};
+
+		const Snapshot &snapshot(const History &history, unsigned int age) const;
+
+		std::vector<History> m_histories;
+
+		/** @brief Newest server time received so far. */
+		double m_newestTime;
+
+		/** @brief Estimated server time minus local Clock time. */
+		double m_clockOffset;
+		bool m_hasClockOffset;
+};
+
+#endif
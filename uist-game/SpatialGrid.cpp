@@ -0,0 +1,160 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SpatialGrid
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+{
+	m_cellSize = cellSize;
+	m_columns = std::max(1, (int)ceil(width / cellSize));
+	m_rows = std::max(1, (int)ceil(height / cellSize));
+	m_size = 0;
+
+	m_cells.resize(m_columns * m_rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpatialGrid::clear()
+{
+	for (unsigned int i = 0; i < m_cells.size(); i++)
+		m_cells[i].clear();
+
+	m_size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpatialGrid::insert(int item, float x, float y)
+{
+	Entry entry;
+	entry.item = item;
+	entry.x = x;
+	entry.y = y;
+
+	m_cells[row(y) * m_columns + column(x)].push_back(entry);
+	m_size++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int SpatialGrid::size() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int SpatialGrid::nearest(float x, float y, float maximalDistance,
+	const std::vector<bool> *isExcluded) const
+{
+	int centerColumn = column(x);
+	int centerRow = row(y);
+
+	int nearestItem = -1;
+	float nearestDistanceSquared = maximalDistance < FLT_MAX
+		? maximalDistance * maximalDistance : FLT_MAX;
+
+	int maximalRing = std::max(m_columns, m_rows);
+
+	// Search rings of cells around the position, starting with its own cell
+	for (int ring = 0; ring <= maximalRing; ring++)
+	{
+		// Items in this ring are at least (ring - 1) cells away
+		if (ring > 0)
+		{
+			float ringDistance = (ring - 1) * m_cellSize;
+
+			if (ringDistance * ringDistance > nearestDistanceSquared)
+				break;
+		}
+
+		for (int r = centerRow - ring; r <= centerRow + ring; r++)
+		{
+			if (r < 0 || r >= m_rows)
+				continue;
+
+			// Only visit the border of the ring
+			bool isBorderRow = (r == centerRow - ring || r == centerRow + ring);
+			int step = isBorderRow ? 1 : 2 * ring;
+
+			for (int c = centerColumn - ring; c <= centerColumn + ring;
+				c += std::max(1, step))
+			{
+				if (c < 0 || c >= m_columns)
+					continue;
+
+				const Cell &cell = m_cells[r * m_columns + c];
+
+				for (Cell::const_iterator i = cell.begin(); i != cell.end(); i++)
+				{
+					if (isExcluded && (unsigned int)i->item < isExcluded->size()
+						&& (*isExcluded)[i->item])
+						continue;
+
+					float dx = i->x - x;
+					float dy = i->y - y;
+					float distanceSquared = dx * dx + dy * dy;
+
+					if (distanceSquared <= nearestDistanceSquared)
+					{
+						nearestDistanceSquared = distanceSquared;
+						nearestItem = i->item;
+					}
+				}
+			}
+		}
+	}
+
+	return nearestItem;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpatialGrid::within(float x, float y, float radius,
+	std::vector<int> &items) const
+{
+	items.clear();
+
+	int firstColumn = column(x - radius);
+	int lastColumn = column(x + radius);
+	int firstRow = row(y - radius);
+	int lastRow = row(y + radius);
+
+	float radiusSquared = radius * radius;
+
+	for (int r = firstRow; r <= lastRow; r++)
+		for (int c = firstColumn; c <= lastColumn; c++)
+		{
+			const Cell &cell = m_cells[r * m_columns + c];
+
+			for (Cell::const_iterator i = cell.begin(); i != cell.end(); i++)
+			{
+				float dx = i->x - x;
+				float dy = i->y - y;
+
+				if (dx * dx + dy * dy <= radiusSquared)
+					items.push_back(i->item);
+			}
+		}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int SpatialGrid::column(float x) const
+{
+	return std::min(m_columns - 1, std::max(0, (int)floor(x / m_cellSize)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int SpatialGrid::row(float y) const
+{
+	return std::min(m_rows - 1, std::max(0, (int)floor(y / m_cellSize)));
+}
@@ -0,0 +1,83 @@
+#ifndef __GENERAL_SPATIALGRID_H
+#define __GENERAL_SPATIALGRID_H
+
+#include <vector>
+#include <cfloat>
+#include <cstddef>
+
+/**
+ * @class SpatialGrid
+ *
+ * @brief Uniform grid of points for fast proximity queries.
+ *
+ * Points are identified by an integer item (e. g. an index into a list). The
+ * grid is meant to be cleared and refilled every frame; clearing keeps the
+ * allocated memory.
+ */
+class SpatialGrid
+{
+	public:
+		/**
+		 * @brief Creates an empty grid.
+		 *
+		 * Points outside of the area are still found, but they share the
+		 * border cells.
+		 *
+		 * @param width - Width of the covered area.
+		 * @param height - Height of the covered area.
+		 * @param cellSize - Edge length of one cell, about the typical query
+		 *     radius.
+		 */
+		SpatialGrid(float width, float height, float cellSize);
+
+		void clear();
+		void insert(int item, float x, float y);
+
+		unsigned int size() const;
+
+		/**
+		 * @brief Finds the item closest to a position.
+		 *
+		 * @param x - X coordinate of the position.
+		 * @param y - Y coordinate of the position.
+		 * @param maximalDistance - Items further away are ignored.
+		 * @param isExcluded - Optional flags indexed by item; flagged items are
+		 *     skipped.
+		 *
+		 * @return The closest item, or -1 if there is none.
+		 */
+		int nearest(float x, float y, float maximalDistance = FLT_MAX,
+			const std::vector<bool> *isExcluded = NULL) const;
+
+		/**
+		 * @brief Finds all items within a radius around a position.
+		 *
+		 * @param x - X coordinate of the position.
+		 * @param y - Y coordinate of the position.
+		 * @param radius - Maximal distance of the items.
+		 * @param items - Receives the found items (in no particular order).
+		 */
+		void within(float x, float y, float radius, std::vector<int> &items) const;
+
+	protected:
+		struct Entry
+		{
+			int item;
+			float x;
+			float y;
+		};
+
+		typedef std::vector<Entry> Cell;
+
+		int column(float x) const;
+		int row(float y) const;
+
+		int m_columns;
+		int m_rows;
+		float m_cellSize;
+
+		std::vector<Cell> m_cells;
+		unsigned int m_size;
+};
+
+#endif
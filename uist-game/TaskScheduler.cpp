@@ -0,0 +1,189 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#include "Profiling.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// TaskScheduler
+//
+////////////////////////////////////////////////////////////////////////////////
+
+TaskScheduler::TaskScheduler(unsigned int numberOfThreads)
+{
+	m_queuedTasks = 0;
+	m_isStopping = false;
+	m_nextQueue = 0;
+
+	if (numberOfThreads == 0)
+		numberOfThreads = std::max(1u, boost::thread::hardware_concurrency());
+
+	// The calling thread of a loop is the remaining one
+	for (unsigned int i = 0; i + 1 < numberOfThreads; i++)
+		m_queues.push_back(new Queue);
+
+	for (unsigned int i = 0; i < m_queues.size(); i++)
+		m_workers.create_thread(boost::bind(&TaskScheduler::work, this, i));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		boost::lock_guard<boost::mutex> lock(m_sleepMutex);
+		m_isStopping = true;
+	}
+
+	m_hasTasks.notify_all();
+	m_workers.join_all();
+
+	for (unsigned int i = 0; i < m_queues.size(); i++)
+		delete m_queues[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int TaskScheduler::numberOfThreads() const
+{
+	return m_queues.size() + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TaskScheduler::parallelFor(unsigned int count, unsigned int grainSize,
+	const RangeFunction &function)
+{
+	grainSize = std::max(1u, grainSize);
+
+	unsigned int numberOfTasks = (count + grainSize - 1) / grainSize;
+
+	// Without workers or with a single range, splitting up doesn't pay off
+	if (m_queues.empty() || numberOfTasks <= 1)
+	{
+		for (unsigned int begin = 0; begin < count; begin += grainSize)
+			function(begin, std::min(begin + grainSize, count));
+
+		return;
+	}
+
+	Loop loop;
+	loop.function = &function;
+	loop.remainingTasks = numberOfTasks;
+
+	// Counted before they are queued, so that the count never drops below 0
+	{
+		boost::lock_guard<boost::mutex> lock(m_sleepMutex);
+		m_queuedTasks += numberOfTasks;
+	}
+
+	// Deal the tasks out to the queues, starting with a different queue for
+	// each loop so that concurrent loops spread evenly
+	unsigned int firstQueue = m_nextQueue++;
+
+	for (unsigned int i = 0; i < numberOfTasks; i++)
+	{
+		Task task;
+		task.loop = &loop;
+		task.begin = i * grainSize;
+		task.end = std::min(task.begin + grainSize, count);
+
+		Queue *queue = m_queues[(firstQueue + i) % m_queues.size()];
+
+		boost::lock_guard<boost::mutex> lock(queue->mutex);
+		queue->tasks.push_back(task);
+	}
+
+	m_hasTasks.notify_all();
+
+	// Help out until the last task of this loop is done. Tasks of other loops
+	// may be run meanwhile, which only keeps this thread busy.
+	while (loop.remainingTasks > 0)
+	{
+		Task task;
+
+		if (takeTask(firstQueue % m_queues.size(), task))
+			runTask(task);
+		else
+			boost::this_thread::yield();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool TaskScheduler::takeTask(unsigned int queueIndex, Task &task)
+{
+	// Own tasks are taken from the back, stolen ones from the front, which
+	// keeps the owner and the thieves apart
+	{
+		Queue *queue = m_queues[queueIndex];
+
+		boost::lock_guard<boost::mutex> lock(queue->mutex);
+
+		if (!queue->tasks.empty())
+		{
+			task = queue->tasks.back();
+			queue->tasks.pop_back();
+			m_queuedTasks--;
+
+			return true;
+		}
+	}
+
+	for (unsigned int i = 1; i < m_queues.size(); i++)
+	{
+		Queue *queue = m_queues[(queueIndex + i) % m_queues.size()];
+
+		boost::lock_guard<boost::mutex> lock(queue->mutex);
+
+		if (!queue->tasks.empty())
+		{
+			task = queue->tasks.front();
+			queue->tasks.pop_front();
+			m_queuedTasks--;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TaskScheduler::runTask(const Task &task)
+{
+	(*task.loop->function)(task.begin, task.end);
+
+	task.loop->remainingTasks--;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TaskScheduler::work(unsigned int queueIndex)
+{
+	PROFILE_THREAD("task scheduler");
+
+	while (true)
+	{
+		Task task;
+
+		if (takeTask(queueIndex, task))
+		{
+			runTask(task);
+			continue;
+		}
+
+		boost::unique_lock<boost::mutex> lock(m_sleepMutex);
+
+		while (m_queuedTasks == 0 && !m_isStopping)
+			m_hasTasks.wait(lock);
+
+		if (m_isStopping)
+			return;
+	}
+}
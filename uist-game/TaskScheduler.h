@@ -0,0 +1,103 @@
+#ifndef __GENERAL_TASKSCHEDULER_H
+#define __GENERAL_TASKSCHEDULER_H
+
+#include <deque>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+/**
+ * @class TaskScheduler
+ *
+ * @brief Pool of threads running the parts of parallel loops.
+ *
+ * Each worker has its own task queue. A worker that runs out of tasks steals
+ * from the other queues, so uneven parts still keep all threads busy. The
+ * thread calling parallelFor works on the loop as well, so several threads
+ * (e. g. the ticks of different game rooms) can share one scheduler.
+ */
+class TaskScheduler
+{
+	public:
+		/** @brief Function processing the items [begin, end) of a loop. */
+		typedef boost::function<void (unsigned int, unsigned int)> RangeFunction;
+
+	public:
+		/**
+		 * @brief Starts the worker threads.
+		 *
+		 * @param numberOfThreads - Threads working on a loop, including the
+		 *     calling one, or 0 for one per processor core. With 1, loops run
+		 *     on the calling thread only.
+		 */
+		TaskScheduler(unsigned int numberOfThreads = 0);
+		~TaskScheduler();
+
+		unsigned int numberOfThreads() const;
+
+		/**
+		 * @brief Processes the items [0, count) in parallel.
+		 *
+		 * The items are split into ranges of grainSize items, which only
+		 * depend on count and grainSize, never on the number of threads. Each
+		 * range is processed exactly once, in no particular order. Returns
+		 * when all ranges are done.
+		 *
+		 * @param count - Number of items.
+		 * @param grainSize - Number of items per range.
+		 * @param function - Called for each range.
+		 */
+		void parallelFor(unsigned int count, unsigned int grainSize,
+			const RangeFunction &function);
+
+	protected:
+		struct Loop
+		{
+			const RangeFunction *function;
+			boost::atomic<unsigned int> remainingTasks;
+		};
+
+		struct Task
+		{
+			Loop *loop;
+			unsigned int begin;
+			unsigned int end;
+		};
+
+		struct Queue
+		{
+			std::deque<Task> tasks;
+			boost::mutex mutex;
+		};
+
+		/**
+		 * @brief Takes a task from a queue, or steals one from the others.
+		 *
+		 * @param queueIndex - The preferred queue.
+		 * @param task - Receives the task.
+		 *
+		 * @return false if all queues are empty.
+		 */
+		bool takeTask(unsigned int queueIndex, Task &task);
+
+		void runTask(const Task &task);
+
+		void work(unsigned int queueIndex);
+
+		std::vector<Queue *> m_queues;
+		boost::thread_group m_workers;
+
+		/** @brief Tasks in all queues, the workers sleep while there are none. */
+		boost::atomic<unsigned int> m_queuedTasks;
+		boost::mutex m_sleepMutex;
+		boost::condition_variable m_hasTasks;
+
+		bool m_isStopping;
+
+		/** @brief Queue the next loop starts to fill. */
+		boost::atomic<unsigned int> m_nextQueue;
+};
+
+#endif
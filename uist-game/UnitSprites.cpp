@@ -0,0 +1,212 @@
+#include "UnitSprites.h"
+
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "GameUnit.h"
+#include "UnitStates.h"
+
+// Numbers a unit can have, as it is stored in a byte
+const unsigned int NUMBERS = 256;
+
+// Room around the unit to rasterize a sprite in, large enough for the
+// highlight circle and a three digit number
+const int SPRITE_MARGIN = 48;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// UnitSprites
+//
+////////////////////////////////////////////////////////////////////////////////
+
+UnitSprites::UnitSprites()
+{
+	clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitSprites::clear()
+{
+	m_sprites.clear();
+	m_sprites.resize(NUMBER_OF_APPEARANCES * NUMBERS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitSprites::render(cv::Mat &image, UnitStates &unitStates,
+	unsigned int index, cv::Point origin)
+{
+	if (image.type() != CV_8UC3)
+	{
+		GameUnit(&unitStates, index).render(image);
+		return;
+	}
+
+	// Truncated like the coordinates of GameUnit::render
+	blend(image, sprite(unitStates, index),
+		cv::Point((int)unitStates.x[index], (int)unitStates.y[index])
+			- origin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+cv::Rect UnitSprites::bounds(UnitStates &unitStates, unsigned int index)
+{
+	const Sprite &unitSprite = sprite(unitStates, index);
+
+	return cv::Rect((int)unitStates.x[index] + unitSprite.offset.x,
+		(int)unitStates.y[index] + unitSprite.offset.y,
+		unitSprite.color.cols, unitSprite.color.rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitSprites::key(const UnitStates &unitStates,
+	unsigned int index)
+{
+	return appearance(unitStates, index) * NUMBERS + unitStates.number[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+UnitSprites::Appearance UnitSprites::appearance(const UnitStates &unitStates,
+	unsigned int index)
+{
+	uint8_t flags = unitStates.flags[index];
+
+	if (flags & UnitStates::UNIT_ARRIVED)
+		return APPEARANCE_ARRIVED;
+
+	if (!(flags & UnitStates::UNIT_LIVING))
+		return APPEARANCE_DEAD;
+
+	bool isFirstClient = (unitStates.owner[index] == ID_FIRST_CLIENT);
+
+	if (flags & UnitStates::UNIT_HIGHLIGHTED)
+		return isFirstClient ? APPEARANCE_FIRST_CLIENT_HIGHLIGHTED
+			: APPEARANCE_OTHER_CLIENT_HIGHLIGHTED;
+
+	return isFirstClient ? APPEARANCE_FIRST_CLIENT : APPEARANCE_OTHER_CLIENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+UnitSprites::Sprite &UnitSprites::sprite(UnitStates &unitStates,
+	unsigned int index)
+{
+	Sprite &unitSprite = m_sprites[key(unitStates, index)];
+
+	if (unitSprite.color.empty())
+		rasterize(unitSprite, unitStates, index);
+
+	return unitSprite;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitSprites::rasterize(Sprite &sprite, const UnitStates &unitStates,
+	unsigned int index)
+{
+	UnitStates spriteUnit;
+	unsigned int spriteIndex = spriteUnit.add(unitStates.messageID[index]);
+
+	spriteUnit.x[spriteIndex] = SPRITE_MARGIN;
+	spriteUnit.y[spriteIndex] = SPRITE_MARGIN;
+	spriteUnit.number[spriteIndex] = unitStates.number[index];
+	spriteUnit.owner[spriteIndex] = unitStates.owner[index];
+	spriteUnit.setFlags(spriteIndex, unitStates.flags[index]);
+
+	// Drawn on black, the unit's pixels are its premultiplied color; drawn
+	// on white, they additionally show how much of the background remains
+	cv::Mat onBlack(2 * SPRITE_MARGIN, 2 * SPRITE_MARGIN, CV_8UC3,
+		cv::Scalar(0, 0, 0));
+	cv::Mat onWhite(2 * SPRITE_MARGIN, 2 * SPRITE_MARGIN, CV_8UC3,
+		cv::Scalar(255, 255, 255));
+
+	GameUnit(&spriteUnit, spriteIndex).render(onBlack);
+	GameUnit(&spriteUnit, spriteIndex).render(onWhite);
+
+	cv::Mat alpha(onBlack.rows, onBlack.cols, CV_8UC1);
+
+	int left = onBlack.cols;
+	int top = onBlack.rows;
+	int right = -1;
+	int bottom = -1;
+
+	for (int row = 0; row < onBlack.rows; row++)
+	{
+		const uint8_t *black = onBlack.ptr<uint8_t>(row);
+		const uint8_t *white = onWhite.ptr<uint8_t>(row);
+		uint8_t *coverage = alpha.ptr<uint8_t>(row);
+
+		for (int column = 0; column < onBlack.cols; column++)
+		{
+			int remaining = 0;
+
+			for (int channel = 0; channel < 3; channel++)
+				remaining = std::max(remaining,
+					white[3 * column + channel] - black[3 * column + channel]);
+
+			coverage[column] = (uint8_t)(255 - remaining);
+
+			if (!coverage[column])
+				continue;
+
+			left = std::min(left, column);
+			right = std::max(right, column);
+			top = std::min(top, row);
+			bottom = std::max(bottom, row);
+		}
+	}
+
+	if (right < left)
+	{
+		// Nothing to draw, kept as a single transparent pixel
+		left = right = top = bottom = 0;
+	}
+
+	cv::Rect bounds(left, top, right - left + 1, bottom - top + 1);
+
+	onBlack(bounds).copyTo(sprite.color);
+	alpha(bounds).copyTo(sprite.alpha);
+	sprite.offset = cv::Point(left - SPRITE_MARGIN, top - SPRITE_MARGIN);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitSprites::blend(cv::Mat &image, const Sprite &sprite,
+	cv::Point position)
+{
+	cv::Point corner = position + sprite.offset;
+
+	// Clipped to the image
+	int firstColumn = std::max(0, -corner.x);
+	int firstRow = std::max(0, -corner.y);
+	int endColumn = std::min(sprite.color.cols, image.cols - corner.x);
+	int endRow = std::min(sprite.color.rows, image.rows - corner.y);
+
+	for (int row = firstRow; row < endRow; row++)
+	{
+		const uint8_t *color = sprite.color.ptr<uint8_t>(row);
+		const uint8_t *alpha = sprite.alpha.ptr<uint8_t>(row);
+		uint8_t *pixel = image.ptr<uint8_t>(corner.y + row);
+
+		for (int column = firstColumn; column < endColumn; column++)
+		{
+			int remaining = 255 - alpha[column];
+
+			if (remaining == 255)
+				continue;
+
+			for (int channel = 0; channel < 3; channel++)
+			{
+				uint8_t &target = pixel[3 * (corner.x + column) + channel];
+
+				target = (uint8_t)std::min(255, color[3 * column + channel]
+					+ (target * remaining + 127) / 255);
+			}
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef __GAME_UNITSPRITES_H
+#define __GAME_UNITSPRITES_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "MessageData.h"
+#include "ForwardDeclarations.h"
+
+/**
+ * @class UnitSprites
+ *
+ * @brief Atlas of pre-rasterized units, blended into the game image.
+ *
+ * Drawing a unit with anti-aliased circles and text is expensive and gives
+ * the same pixels for all units that look alike. A unit's look only depends
+ * on its number and on its appearance (arrived, dead, owner, highlighted), so
+ * each combination is rasterized once with GameUnit::render, the first time it
+ * is needed, and afterwards only blended at the unit's position.
+ *
+ * Sprites are stored with premultiplied color, so blending one pixel is
+ * image = sprite + image * (255 - alpha) / 255.
+ */
+class UnitSprites
+{
+	public:
+		UnitSprites();
+
+		/** @brief Forgets all sprites, e. g. after GameUnit::s_radius changed. */
+		void clear();
+
+		/**
+		 * @brief Draws a unit like GameUnit::render does.
+		 *
+		 * @param image - 8 bit BGR image; other types are drawn directly.
+		 * @param unitStates - The units.
+		 * @param index - Index of the unit to draw.
+		 * @param origin - Position of the image's top left pixel, if it is a
+		 *     region of a larger 8 bit BGR image.
+		 */
+		void render(cv::Mat &image, UnitStates &unitStates,
+			unsigned int index, cv::Point origin = cv::Point(0, 0));
+
+		/** @brief Returns the pixels render changes for a unit. */
+		cv::Rect bounds(UnitStates &unitStates, unsigned int index);
+
+		/** @brief Identifies the sprite of a unit: equal keys look alike. */
+		static unsigned int key(const UnitStates &unitStates,
+			unsigned int index);
+
+	protected:
+		enum Appearance
+		{
+			APPEARANCE_ARRIVED,
+			APPEARANCE_DEAD,
+			APPEARANCE_FIRST_CLIENT,
+			APPEARANCE_OTHER_CLIENT,
+			APPEARANCE_FIRST_CLIENT_HIGHLIGHTED,
+			APPEARANCE_OTHER_CLIENT_HIGHLIGHTED,
+			NUMBER_OF_APPEARANCES
+		};
+
+		struct Sprite
+		{
+			/** @brief Premultiplied color, CV_8UC3. Empty if not rasterized. */
+			cv::Mat color;
+
+			/** @brief Coverage, CV_8UC1. */
+			cv::Mat alpha;
+
+			/** @brief Top left corner relative to the unit's position. */
+			cv::Point offset;
+		};
+
+		static Appearance appearance(const UnitStates &unitStates,
+			unsigned int index);
+
+		/** @brief Returns the sprite of a unit, rasterized if needed. */
+		Sprite &sprite(UnitStates &unitStates, unsigned int index);
+
+		/** @brief Draws a copy of the unit and crops it to its pixels. */
+		static void rasterize(Sprite &sprite, const UnitStates &unitStates,
+			unsigned int index);
+
+		static void blend(cv::Mat &image, const Sprite &sprite,
+			cv::Point position);
+
+		/** @brief Indexed by appearance * 256 + number. */
+		std::vector<Sprite> m_sprites;
+};
+
+#endif
@@ -0,0 +1,367 @@
+#include "UnitStates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNITSTATES_SSE2
+#include <emmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// UnitStates
+//
+////////////////////////////////////////////////////////////////////////////////
+
+UnitStates::UnitStates()
+{
+	m_numberOfArrivedSheep = 0;
+	m_numberOfSurvivingSheep = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::add(MessageID unitMessageID)
+{
+	x.push_back(0.0f);
+	y.push_back(0.0f);
+	vx.push_back(0.0f);
+	vy.push_back(0.0f);
+	ax.push_back(0.0f);
+	ay.push_back(0.0f);
+
+	flags.push_back(UNIT_LIVING);
+	number.push_back(0);
+	owner.push_back(ID_NONE);
+	messageID.push_back(unitMessageID);
+
+	m_indexByID.insert(unitMessageID, size() - 1);
+
+	countSheep(UNIT_LIVING, 1);
+
+	return size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::append(unsigned int count,
+	MessageID firstMessageID)
+{
+	unsigned int first = size();
+	unsigned int newSize = first + count;
+
+	x.resize(newSize, 0.0f);
+	y.resize(newSize, 0.0f);
+	vx.resize(newSize, 0.0f);
+	vy.resize(newSize, 0.0f);
+	ax.resize(newSize, 0.0f);
+	ay.resize(newSize, 0.0f);
+
+	flags.resize(newSize, UNIT_LIVING);
+	number.resize(newSize, 0);
+	owner.resize(newSize, ID_NONE);
+	messageID.resize(newSize);
+
+	for (unsigned int i = first; i < newSize; i++)
+	{
+		messageID[i] = firstMessageID + (i - first);
+		m_indexByID.insert(messageID[i], i);
+	}
+
+	// New units are surviving sheep
+	m_numberOfSurvivingSheep += count;
+
+	return first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::clear()
+{
+	x.clear();
+	y.clear();
+	vx.clear();
+	vy.clear();
+	ax.clear();
+	ay.clear();
+
+	flags.clear();
+	number.clear();
+	owner.clear();
+	messageID.clear();
+
+	m_indexByID.clear();
+
+	m_numberOfArrivedSheep = 0;
+	m_numberOfSurvivingSheep = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::size() const
+{
+	return x.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void appendArray(std::vector<char> &data, const std::vector<T> &array)
+{
+	if (array.empty())
+		return;
+
+	const char *begin = (const char *)&array[0];
+	data.insert(data.end(), begin, begin + array.size() * sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+const char *assignArray(std::vector<T> &array, const char *data,
+	unsigned int count)
+{
+	array.resize(count);
+
+	// The block need not be aligned for T
+	if (count)
+		memcpy(&array[0], data, count * sizeof(T));
+
+	return data + count * sizeof(T);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::appendTo(std::vector<char> &data) const
+{
+	data.reserve(data.size() + byteSize(size()));
+
+	appendArray(data, x);
+	appendArray(data, y);
+	appendArray(data, vx);
+	appendArray(data, vy);
+	appendArray(data, ax);
+	appendArray(data, ay);
+
+	appendArray(data, flags);
+	appendArray(data, number);
+	appendArray(data, owner);
+	appendArray(data, messageID);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::assign(const char *data, unsigned int count)
+{
+	data = assignArray(x, data, count);
+	data = assignArray(y, data, count);
+	data = assignArray(vx, data, count);
+	data = assignArray(vy, data, count);
+	data = assignArray(ax, data, count);
+	data = assignArray(ay, data, count);
+
+	data = assignArray(flags, data, count);
+	data = assignArray(number, data, count);
+	data = assignArray(owner, data, count);
+	data = assignArray(messageID, data, count);
+
+	m_indexByID.clear();
+	m_numberOfArrivedSheep = 0;
+	m_numberOfSurvivingSheep = 0;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m_indexByID.insert(messageID[i], i);
+		countSheep(flags[i], 1);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::byteSize(unsigned int count)
+{
+	return count * (6 * sizeof(float) + 2 * sizeof(uint8_t)
+		+ sizeof(PlayerID) + sizeof(MessageID));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int UnitStates::indexByID(MessageID unitMessageID) const
+{
+	return m_indexByID.find(unitMessageID);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::setFlags(unsigned int index, uint8_t newFlags)
+{
+	if (flags[index] == newFlags)
+		return;
+
+	countSheep(flags[index], -1);
+	countSheep(newFlags, 1);
+
+	flags[index] = newFlags;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::numberOfArrivedSheep() const
+{
+	return m_numberOfArrivedSheep;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int UnitStates::numberOfSurvivingSheep() const
+{
+	return m_numberOfSurvivingSheep;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::countSheep(uint8_t unitFlags, int difference)
+{
+	if ((unitFlags & UNIT_HUNTING) || !(unitFlags & UNIT_LIVING))
+		return;
+
+	if (unitFlags & UNIT_ARRIVED)
+		m_numberOfArrivedSheep += difference;
+	else
+		m_numberOfSurvivingSheep += difference;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::move(float timeDifference, float maximalVelocity,
+	float brakeFactor, unsigned int begin, unsigned int end)
+{
+	unsigned int count = std::min(end, size());
+
+	// Stopped units simply integrate zeros below, which keeps the kernel free
+	// of branches
+	for (unsigned int i = begin; i < count; i++)
+	{
+		if ((flags[i] & UNIT_LIVING) && !(flags[i] & UNIT_ARRIVED))
+			continue;
+
+		vx[i] = vy[i] = 0.0f;
+		ax[i] = ay[i] = 0.0f;
+	}
+
+	unsigned int i = begin;
+
+#ifdef UNITSTATES_SSE2
+	const __m128 dt = _mm_set1_ps(timeDifference);
+	const __m128 brake = _mm_set1_ps(brakeFactor);
+	const __m128 limit = _mm_set1_ps(maximalVelocity);
+	const __m128 limitSquared = _mm_set1_ps(maximalVelocity * maximalVelocity);
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 velocityX = _mm_loadu_ps(&vx[i]);
+		__m128 velocityY = _mm_loadu_ps(&vy[i]);
+
+		// Brake the object slightly
+		__m128 accelerationX = _mm_sub_ps(_mm_loadu_ps(&ax[i]),
+			_mm_mul_ps(velocityX, brake));
+		__m128 accelerationY = _mm_sub_ps(_mm_loadu_ps(&ay[i]),
+			_mm_mul_ps(velocityY, brake));
+
+		velocityX = _mm_add_ps(velocityX, _mm_mul_ps(accelerationX, dt));
+		velocityY = _mm_add_ps(velocityY, _mm_mul_ps(accelerationY, dt));
+
+		// If the speed exceeds the maximal speed, reset it to the maximum
+		__m128 speedSquared = _mm_add_ps(_mm_mul_ps(velocityX, velocityX),
+			_mm_mul_ps(velocityY, velocityY));
+		__m128 isTooFast = _mm_cmpgt_ps(speedSquared, limitSquared);
+		__m128 scale = _mm_or_ps(
+			_mm_and_ps(isTooFast, _mm_div_ps(limit, _mm_sqrt_ps(speedSquared))),
+			_mm_andnot_ps(isTooFast, one));
+
+		velocityX = _mm_mul_ps(velocityX, scale);
+		velocityY = _mm_mul_ps(velocityY, scale);
+
+		_mm_storeu_ps(&vx[i], velocityX);
+		_mm_storeu_ps(&vy[i], velocityY);
+
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]),
+			_mm_mul_ps(velocityX, dt)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]),
+			_mm_mul_ps(velocityY, dt)));
+	}
+#endif
+
+	// Remaining units (or all without SSE2)
+	for (; i < count; i++)
+	{
+		vx[i] += (ax[i] - vx[i] * brakeFactor) * timeDifference;
+		vy[i] += (ay[i] - vy[i] * brakeFactor) * timeDifference;
+
+		float speed = sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+
+		if (speed > maximalVelocity)
+		{
+			vx[i] *= maximalVelocity / speed;
+			vy[i] *= maximalVelocity / speed;
+		}
+
+		x[i] += vx[i] * timeDifference;
+		y[i] += vy[i] * timeDifference;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void UnitStates::reflectOnWalls(float minimum, float maximum,
+	unsigned int begin, unsigned int end)
+{
+	unsigned int count = std::min(end, size());
+	unsigned int i = begin;
+
+#ifdef UNITSTATES_SSE2
+	const __m128 lower = _mm_set1_ps(minimum);
+	const __m128 upper = _mm_set1_ps(maximum);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 positionX = _mm_loadu_ps(&x[i]);
+		__m128 positionY = _mm_loadu_ps(&y[i]);
+
+		// Invert the velocity of all units outside of the walls
+		__m128 isOutsideX = _mm_or_ps(_mm_cmplt_ps(positionX, lower),
+			_mm_cmpgt_ps(positionX, upper));
+		__m128 isOutsideY = _mm_or_ps(_mm_cmplt_ps(positionY, lower),
+			_mm_cmpgt_ps(positionY, upper));
+
+		_mm_storeu_ps(&vx[i], _mm_xor_ps(_mm_loadu_ps(&vx[i]),
+			_mm_and_ps(isOutsideX, signBit)));
+		_mm_storeu_ps(&vy[i], _mm_xor_ps(_mm_loadu_ps(&vy[i]),
+			_mm_and_ps(isOutsideY, signBit)));
+
+		// And put them back onto the walls
+		_mm_storeu_ps(&x[i], _mm_min_ps(_mm_max_ps(positionX, lower), upper));
+		_mm_storeu_ps(&y[i], _mm_min_ps(_mm_max_ps(positionY, lower), upper));
+	}
+#endif
+
+	// Remaining units (or all without SSE2)
+	for (; i < count; i++)
+	{
+		if (x[i] < minimum || x[i] > maximum)
+		{
+			x[i] = std::min(std::max(x[i], minimum), maximum);
+			vx[i] = -vx[i];
+		}
+
+		if (y[i] < minimum || y[i] > maximum)
+		{
+			y[i] = std::min(std::max(y[i], minimum), maximum);
+			vy[i] = -vy[i];
+		}
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef __GAME_UNITSTATES_H
+#define __GAME_UNITSTATES_H
+
+#include <vector>
+
+#include "MessageData.h"
+#include "MessageIDMap.h"
+
+/**
+ * @class UnitStates
+ *
+ * @brief Simulation state of all game units as structure of arrays.
+ *
+ * Each unit is an index into the arrays. Keeping each quantity contiguous lets
+ * the batch kernels (move, reflectOnWalls) process four units per SSE
+ * instruction. GameUnit provides the per-unit view on top of this.
+ *
+ * The number of arrived and surviving sheep is counted along as the flags
+ * change, so the score is known at any time without scanning the units. To
+ * keep the counts right, flags must only be changed through setFlags.
+ */
+class UnitStates
+{
+	public:
+		/** @brief Bits of the flags array. */
+		enum
+		{
+			UNIT_LIVING = 1 << 0,
+			UNIT_HUNTING = 1 << 1,
+			UNIT_ARRIVED = 1 << 2,
+			UNIT_HIGHLIGHTED = 1 << 3
+		};
+
+		UnitStates();
+
+		/**
+		 * @brief Appends a living unit at the origin without velocity.
+		 *
+		 * @param messageID - The ID the unit is synchronized with.
+		 *
+		 * @return Index of the new unit.
+		 */
+		unsigned int add(MessageID messageID);
+
+		/**
+		 * @brief Appends several living units at once.
+		 *
+		 * @param count - Number of units to append.
+		 * @param firstMessageID - ID of the first new unit, the others follow
+		 *     consecutively.
+		 *
+		 * @return Index of the first new unit.
+		 */
+		unsigned int append(unsigned int count, MessageID firstMessageID);
+
+		void clear();
+		unsigned int size() const;
+
+		/**
+		 * @brief Appends all arrays to a block of memory, one after another.
+		 *
+		 * @param data - Receives byteSize(size()) more bytes.
+		 */
+		void appendTo(std::vector<char> &data) const;
+
+		/**
+		 * @brief Replaces all units by ones written with appendTo.
+		 *
+		 * @param data - Points to byteSize(count) bytes.
+		 * @param count - Number of units in the block.
+		 */
+		void assign(const char *data, unsigned int count);
+
+		/** @brief Returns the bytes appendTo writes for a number of units. */
+		static unsigned int byteSize(unsigned int count);
+
+		/**
+		 * @brief Looks up a unit by its message ID in constant time.
+		 *
+		 * @return Index of the unit, or -1 if there is none.
+		 */
+		int indexByID(MessageID messageID) const;
+
+		/** @brief Changes all flags of a unit, updating the sheep counts. */
+		void setFlags(unsigned int index, uint8_t newFlags);
+
+		/** @brief Returns the number of living sheep behind the goal line. */
+		unsigned int numberOfArrivedSheep() const;
+
+		/** @brief Returns the number of living sheep before the goal line. */
+		unsigned int numberOfSurvivingSheep() const;
+
+		/**
+		 * @brief Integrates velocities and positions of all units.
+		 *
+		 * Units that are dead or have arrived lose velocity and acceleration.
+		 *
+		 * @param timeDifference - Length of the step in seconds.
+		 * @param maximalVelocity - Speed limit of all units.
+		 * @param brakeFactor - Fraction of the velocity braking per second.
+		 * @param begin - First unit to integrate.
+		 * @param end - Index after the last unit to integrate, or -1 for all
+		 *     remaining units.
+		 */
+		void move(float timeDifference, float maximalVelocity,
+			float brakeFactor, unsigned int begin = 0, unsigned int end = -1);
+
+		/**
+		 * @brief Keeps all units within a square, bouncing off its borders.
+		 *
+		 * @param minimum - Lowest allowed coordinate.
+		 * @param maximum - Highest allowed coordinate.
+		 * @param begin - First unit to keep within the walls.
+		 * @param end - Index after the last unit, or -1 for all remaining
+		 *     units.
+		 */
+		void reflectOnWalls(float minimum, float maximum,
+			unsigned int begin = 0, unsigned int end = -1);
+
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> vx;
+		std::vector<float> vy;
+		std::vector<float> ax;
+		std::vector<float> ay;
+
+		std::vector<uint8_t> flags;
+		std::vector<uint8_t> number;
+		std::vector<PlayerID> owner;
+		std::vector<MessageID> messageID;
+
+	protected:
+		/** @brief Adds a unit with the given flags to the sheep counts, or
+		 * removes it if difference is -1. */
+		void countSheep(uint8_t unitFlags, int difference);
+
+		/** @brief Index of each unit by its message ID. */
+		MessageIDMap m_indexByID;
+
+		unsigned int m_numberOfArrivedSheep;
+		unsigned int m_numberOfSurvivingSheep;
+};
+
+#endif